@@ -3,9 +3,12 @@
 #include "../ecs/Component.h"
 #include "../ecs/Entity.h"
 #include "Transform.h"
-#include "../sdlutils/InputHandler.h"
+#include "../game/World.h"
+#include "../game/ParticleSystem.h"
 #include "../sdlutils/SDLUtils.h"
 #include "../utils/Vector2D.h"
+#include "../utils/FastRotation.h"
+#include "../utils/Vec2.h"
 
 // Controla el caza:
 // - Flechas izquierda/derecha: girar 5 grados
@@ -15,14 +18,19 @@ struct FighterControl : ecs::Component {
     __CMPID_DECL__(ecs::cmp::FIGHTERCONTROL)
 
         FighterControl(float thrust = 0.2f, float speedLimit = 3.0f)
-        : _thrust(thrust), _speedLimit(speedLimit) {
+        : _thrust(thrust), _speedLimit(speedLimit), _sound(nullptr) {
+    }
+
+    // El sonido se busca una vez, no en cada frame (ver ResourceCache)
+    void initComponent() override {
+        _sound = &sdlutils().soundEffects().at("thrust");
     }
 
     void update() override {
         auto* tr = _ent->getComponent<Transform>();
         assert(tr != nullptr);
 
-        auto& ihdlr = ih();
+        auto& ihdlr = _ent->getWorld()->input();
 
         // Girar con flechas izquierda/derecha
         if (ihdlr.isKeyDown(SDL_SCANCODE_LEFT))
@@ -35,18 +43,30 @@ struct FighterControl : ecs::Component {
             Vector2D vel = tr->getVel();
             float rot = tr->getRot();
 
-            Vector2D newVel = vel + Vector2D(0.0f, -1.0f).rotate(rot) * _thrust;
+            // la rotacion va en pasos de 5 grados, seno/coseno de la tabla
+            SinCos sc = fastrot::steps5().get(rot);
+            Vector2D up = Vector2D(0.0f, -1.0f).rotate(sc.sin, sc.cos);
+            Vector2D newVel = vel + up * _thrust;
             if (newVel.magnitude() > _speedLimit)
                 newVel = newVel.normalize() * _speedLimit;
 
             tr->getVel() = newVel;
 
+            // Humo saliendo por detras del caza (si el mundo se pinta)
+            auto* particles = _ent->getWorld()->getParticles();
+            if (particles != nullptr) {
+                Vec2 u = toVec2(up);
+                Vec2 center = toVec2(tr->getPos()) + Vec2(tr->getWidth(), tr->getHeight()) * 0.5f;
+                particles->thrust(center - u * (tr->getHeight() * 0.5f), -u);
+            }
+
             // Sonido de empuje
-            sdlutils().soundEffects().at("thrust").play();
+            _sound->play();
         }
     }
 
 private:
     float _thrust;
     float _speedLimit;
+    const SoundEffect* _sound;
 };
\ No newline at end of file
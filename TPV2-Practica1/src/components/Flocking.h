@@ -0,0 +1,44 @@
+#pragma once
+#include <cassert>
+#include "../ecs/Component.h"
+#include "../ecs/Entity.h"
+#include "Transform.h"
+#include "../game/World.h"
+#include "../game/SteeringSystem.h"
+
+// El asteroide tiene en cuenta a los asteroides cercanos (boids):
+//  - separacion: se aparta de los que tiene muy cerca, para no solaparse,
+//  - alineamiento: tiende a ir en la direccion media de sus vecinos,
+//  - cohesion: tiende a ir hacia el centro de sus vecinos.
+// Cada regla tiene su peso; solo cambian la direccion, no la velocidad.
+//
+// El calculo lo hace SteeringSystem para todos los asteroides a la vez
+// (ver SteeringSystem::updateFlockers), el componente solo se registra
+
+struct Flocking : ecs::Component {
+    __CMPID_DECL__(ecs::cmp::FLOCKING)
+
+        Flocking() : Flocking(1.0f, 0.02f, 0.0005f) {}
+    Flocking(float separation, float alignment, float cohesion) :
+        _separation(separation), _alignment(alignment), _cohesion(cohesion),
+        _steeringIdx(-1) {}
+
+    virtual ~Flocking() {
+        if (_steeringIdx >= 0)
+            _ent->getWorld()->getSteering()->removeFlocker(this);
+    }
+
+    void initComponent() override {
+        auto* tr = _ent->getComponent<Transform>();
+        assert(tr != nullptr);
+        _ent->getWorld()->getSteering()->addFlocker(this, tr, _separation, _alignment, _cohesion);
+    }
+
+private:
+    friend class SteeringSystem;
+
+    float    _separation;
+    float    _alignment;
+    float    _cohesion;
+    int      _steeringIdx;  // posicion en los arrays de SteeringSystem
+};
\ No newline at end of file
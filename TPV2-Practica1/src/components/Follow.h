@@ -1,35 +1,38 @@
 #pragma once
+#include <cassert>
 #include "../ecs/Component.h"
 #include "../ecs/Entity.h"
-#include "../ecs/EntityManager.h"
 #include "Transform.h"
-#include "ecs_defs.h"
+#include "Wraparound.h"
+#include "../game/World.h"
+#include "../game/SteeringSystem.h"
 
 // El asteroide actualiza su velocidad para seguir al caza.
 // Formula del enunciado: v = v.rotate(v.angle(q-p) > 0 ? 1.0f : -1.0f)
+//
+// El calculo lo hace SteeringSystem para todos los asteroides a la vez
+// (ver SteeringSystem::updateFollowers), el componente solo se registra.
+// Hay que anadirlo despues de WrapAround (si lo tiene), porque al
+// registrarse se decide si puede atajar dando la vuelta a la pantalla
 
 struct Follow : ecs::Component {
     __CMPID_DECL__(ecs::cmp::FOLLOW)
 
-        Follow() {}
+        Follow() : _steeringIdx(-1) {}
 
-    void update() override {
-        auto* tr = _ent->getComponent<Transform>();
-        if (tr == nullptr) return;
-
-        // Obtener posicion del caza via handler
-        auto* fighter = _ent->getMngr()->getHandler(ecs::hdlr::FIGHTER_HDLR);
-        if (fighter == nullptr || !fighter->isAlive()) return;
+    virtual ~Follow() {
+        if (_steeringIdx >= 0)
+            _ent->getWorld()->getSteering()->removeFollower(this);
+    }
 
-        auto* fighterTr = fighter->getComponent<Transform>();
-        if (fighterTr == nullptr) return;
+    void initComponent() override {
+        auto* tr = _ent->getComponent<Transform>();
+        assert(tr != nullptr);
+        _ent->getWorld()->getSteering()->addFollower(this, tr, _ent->hasComponent<WrapAround>());
+    }
 
-        Vector2D p = tr->getPos();
-        Vector2D q = fighterTr->getPos();
-        Vector2D v = tr->getVel();
+private:
+    friend class SteeringSystem;
 
-        // Girar ligeramente hacia el caza
-        float ang = v.angle(q - p);
-        tr->getVel() = v.rotate(ang > 0 ? 1.0f : -1.0f);
-    }
+    int _steeringIdx;  // posicion en los arrays de SteeringSystem
 };
\ No newline at end of file
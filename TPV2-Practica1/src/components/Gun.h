@@ -1,71 +1,53 @@
 #pragma once
-#include <array>
 #include <cassert>
 #include <cstdint>
+#include <string>
 #include "../ecs/Component.h"
 #include "../ecs/Entity.h"
 #include "Transform.h"
-#include "../sdlutils/InputHandler.h"
+#include "../game/World.h"
+#include "../game/ProjectileSystem.h"
 #include "../sdlutils/SDLUtils.h"
 #include "../utils/Vector2D.h"
+#include "../utils/Vec2.h"
+#include "../utils/FastRotation.h"
+
+// Dispara con S. Las balas no son del arma: viven en el ProjectileSystem del
+// mundo, que las mueve, las pinta y las elimina al salir de la pantalla. El
+// arma se registra como duenio con un tipo ("fighter" por defecto), y el
+// fichero de configuracion da el maximo de balas vivas y el tiempo entre
+// disparos de cada tipo.
 
 struct Gun : ecs::Component {
     __CMPID_DECL__(ecs::cmp::GUN)
 
-        struct Bullet {
-        bool     used = false;
-        Vector2D pos;           // top-left
-        Vector2D vel;
-        float    rot = 0.0f; // grados, misma que el caza
-        float    width = 5.0f;
-        float    height = 14.0f;
-    };
-
-    static constexpr int MAX_BULLETS = 20;
-    typedef std::array<Bullet, MAX_BULLETS> BulletArray;
-    typedef BulletArray::iterator iterator;
+        Gun() : Gun("fighter") {}
+    Gun(const std::string& kind)
+        : _kind(kind), _owner(-1), _ready(true), _cooldownTimer(TimerWheel::INVALID),
+        _sound(nullptr) {}
 
-    Gun() : _lastShootTime(0), _lastIdx(0) { reset(); }
+    virtual ~Gun() {
+        _ent->getWorld()->timers().cancel(_cooldownTimer);
+        if (_owner >= 0)
+            _ent->getWorld()->getProjectiles()->removeOwner(_owner);
+    }
 
-    void reset() { for (auto& b : _bullets) b.used = false; }
+    void initComponent() override {
+        _owner = _ent->getWorld()->getProjectiles()->addOwner(_kind);
+        _sound = &sdlutils().soundEffects().at("gunshot");  // una vez, no en cada disparo
+    }
 
-    iterator begin() { return _bullets.begin(); }
-    iterator end() { return _bullets.end(); }
+    // Elimina las balas de este arma
+    void reset() { _ent->getWorld()->getProjectiles()->clear(_owner); }
 
     void update() override {
-        float sw = (float)sdlutils().width();
-        float sh = (float)sdlutils().height();
-
-        for (auto& b : _bullets) {
-            if (!b.used) continue;
-            b.pos = b.pos + b.vel;
-            if (b.pos.getX() < -b.width || b.pos.getX() > sw ||
-                b.pos.getY() < -b.height || b.pos.getY() > sh)
-                b.used = false;
-        }
-
-        if (ih().isKeyDown(SDL_SCANCODE_S)) {
-            uint32_t now = sdlutils().virtualTimer().currTime();
-            if (now - _lastShootTime >= 250u) {
-                _lastShootTime = now;
-                fire();
-            }
-        }
-    }
-
-    void render() override {
-        const auto& tex = sdlutils().images().at("fire");
-        for (const auto& b : _bullets) {
-            if (!b.used) continue;
-            // Renderizar sin rotacion visual para simplificar
-            // (la bala va en la direccion correcta, solo el sprite es siempre vertical)
-            SDL_FRect dest{
-                b.pos.getX(),
-                b.pos.getY(),
-                b.width,
-                b.height
-            };
-            tex.render(dest);
+        if (_ready && _ent->getWorld()->input().isKeyDown(SDL_SCANCODE_S)) {
+            fire();
+            // No vuelve a disparar hasta que pase el tiempo entre disparos
+            _ready = false;
+            _cooldownTimer = _ent->getWorld()->timers().schedule(
+                _ent->getWorld()->getProjectiles()->cooldown(_owner),
+                [this]() { _ready = true; });
         }
     }
 
@@ -85,7 +67,8 @@ private:
 
         // La punta del caza esta arriba del centro, rotada segun r
         // Vector "arriba" del caza = (0,-1) rotado r grados
-        Vector2D up = Vector2D(0.0f, -1.0f).rotate(r);
+        SinCos sc = fastrot::steps5().get(r);
+        Vector2D up = Vector2D(0.0f, -1.0f).rotate(sc.sin, sc.cos);
 
         // La bala sale de la punta: centro + up * (h/2 + 2)
         Vector2D bulletCenter = center + up * (h * 0.5f + 2.0f);
@@ -98,24 +81,14 @@ private:
         float speed = vel.magnitude() + 8.0f;
         Vector2D bv = up * speed;
 
-        // Insertar en pool circular
-        for (int i = 0; i < MAX_BULLETS; i++) {
-            int idx = (_lastIdx + 1 + i) % MAX_BULLETS;
-            if (!_bullets[idx].used) {
-                _bullets[idx].used = true;
-                _bullets[idx].pos = bp;
-                _bullets[idx].vel = bv;
-                _bullets[idx].rot = r;
-                _bullets[idx].width = bw;
-                _bullets[idx].height = bh;
-                _lastIdx = idx;
-                sdlutils().soundEffects().at("gunshot").play();
-                return;
-            }
-        }
+        // Si el pool o el limite de este arma estan llenos, no dispara
+        if (_ent->getWorld()->getProjectiles()->spawn(_owner, toVec2(bp), toVec2(bv), bw, bh, r))
+            _sound->play();
     }
 
-    uint32_t   _lastShootTime;
-    int        _lastIdx;
-    BulletArray _bullets;
+    std::string _kind;
+    int         _owner;  // duenio en el ProjectileSystem
+    bool        _ready;  // ha pasado el tiempo entre disparos
+    TimerWheel::TimerId _cooldownTimer;
+    const SoundEffect* _sound;
 };
\ No newline at end of file
@@ -5,32 +5,40 @@
 #include <cassert>
 
 #include "../ecs/Entity.h"
+#include "../game/CullingSystem.h"
+#include "../game/World.h"
 #include "../sdlutils/macros.h"
+#include "../sdlutils/SDLUtils.h"
 #include "../sdlutils/Texture.h"
 #include "Transform.h"
 
 Image::Image() :
-		_tr(), _tex() {
+		_tr(), _tex(), _visible(true), _cullIdx(-1) {
 }
 
 Image::Image(const Texture *tex) :
-		_tr(), _tex(tex) {
+		_tr(), _tex(tex), _visible(true), _cullIdx(-1) {
 }
 
 Image::~Image() {
+	if (_cullIdx >= 0)
+		_ent->getWorld()->getCulling()->removeImage(this);
 }
 
 void Image::initComponent() {
 	_tr = _ent->getComponent<Transform>();
 	assert(_tr != nullptr);
+	_ent->getWorld()->getCulling()->addImage(this, _tr);
 }
 
 void Image::render() {
+	if (!_visible)
+		return;
 
 	SDL_FRect dest = build_sdlfrect(_tr->getPos(), _tr->getWidth(),
 			_tr->getHeight());
 
 	assert(_tex != nullptr);
-	_tex->render(dest, _tr->getRot());
+	sdlutils().commands().draw(*_tex, dest, _tr->getRot());
 
 }
@@ -29,7 +29,11 @@ public:
 	void render() override;
 
 private:
+	friend class CullingSystem;
+
 	Transform *_tr;
 	const Texture *_tex;
+	bool _visible; // set by the world's CullingSystem before rendering
+	int _cullIdx; // position in the arrays of CullingSystem
 };
 
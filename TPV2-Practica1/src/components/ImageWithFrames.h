@@ -3,68 +3,67 @@
 #include "../ecs/Entity.h"
 #include "Transform.h"
 #include "../sdlutils/SDLUtils.h"
-#include "../sdlutils/Texture.h"
+#include "../sdlutils/AnimationClip.h"
+#include "../game/World.h"
+#include "../game/CullingSystem.h"
 
-// Spritesheet: 6 columnas x 5 filas = 30 frames
-// Paso entre frames: 89px horizontal, 101px vertical
-// Tamano del frame visible: 74x84 px
+// Sprite animado. Los datos de la animacion (spritesheet, tamano de los
+// frames, fps) son un AnimationClip compartido, cargado del fichero de
+// recursos ("asteroid" y "asteroid_gold"). Cada entidad solo guarda el clip
+// y una fase: el frame sale del tiempo virtual, igual para todas, asi que
+// no hay nada que actualizar.
+//
+// Si CullingSystem dice que esta fuera de la pantalla, no se pinta.
 
 struct ImageWithFrames : ecs::Component {
     __CMPID_DECL__(ecs::cmp::IMAGEWITHFRAMES)
 
-        static constexpr int COLS = 6;
-    static constexpr int ROWS = 5;
-    static constexpr int N_FRAMES = COLS * ROWS; // 30
-    static constexpr int STEP_X = 89;   // paso horizontal entre frames
-    static constexpr int STEP_Y = 101;  // paso vertical entre frames
-    static constexpr int FRAME_W = 74;   // ancho visible del frame
-    static constexpr int FRAME_H = 84;   // alto visible del frame
-
-    ImageWithFrames() : _frame(0), _lastTime(0) {
-        _texKey = (sdlutils().rand().nextInt(0, 2) == 0)
-            ? "asteroid" : "asteroid_gold";
+        ImageWithFrames() : _clip(nullptr), _phase(0), _tr(nullptr), _visible(true), _cullIdx(-1) {
     }
 
-    void initComponent() override {
-        _frame = sdlutils().rand().nextInt(0, N_FRAMES);
-        _lastTime = sdlutils().virtualTimer().currTime();
+    ImageWithFrames(const std::string& clip) : _clip(nullptr), _phase(0), _tr(nullptr), _visible(true), _cullIdx(-1) {
+        _clip = &sdlutils().animations().at(clip);
     }
 
-    void update() override {
-        uint32_t now = sdlutils().virtualTimer().currTime();
-        if (now - _lastTime >= 50u) {
-            _lastTime = now;
-            _frame = (_frame + 1) % N_FRAMES;
-        }
+    virtual ~ImageWithFrames() {
+        if (_cullIdx >= 0)
+            _ent->getWorld()->getCulling()->removeAnimated(this);
     }
 
-    void render() override {
-        auto* tr = _ent->getComponent<Transform>();
-        if (tr == nullptr) return;
+    void initComponent() override {
+        auto& rng = _ent->getWorld()->rand();
+        if (_clip == nullptr)
+            _clip = &sdlutils().animations().at(
+                (rng.nextInt(0, 2) == 0) ? "asteroid" : "asteroid_gold");
 
-        const auto& tex = sdlutils().images().at(_texKey);
+        // Empieza en un frame aleatorio, para que no giren todos a la vez
+        _phase = rng.nextInt(0, _clip->numFrames());
 
-        int col = _frame % COLS;
-        int row = _frame / COLS;
+        _tr = _ent->getComponent<Transform>();
+        if (_tr != nullptr)
+            _ent->getWorld()->getCulling()->addAnimated(this, _tr);
+    }
+
+    void render() override {
+        if (_tr == nullptr || !_visible) return;
 
-        SDL_FRect src{
-            (float)(col * STEP_X),
-            (float)(row * STEP_Y),
-            (float)FRAME_W,
-            (float)FRAME_H
-        };
         SDL_FRect dest{
-            tr->getPos().getX(),
-            tr->getPos().getY(),
-            tr->getWidth(),
-            tr->getHeight()
+            _tr->getPos().getX(),
+            _tr->getPos().getY(),
+            _tr->getWidth(),
+            _tr->getHeight()
         };
 
-        tex.render(src, dest);
+        _clip->render(sdlutils().commands(), dest,
+            _ent->getWorld()->clock().currTime(), _phase);
     }
 
 private:
-    int         _frame;
-    uint32_t    _lastTime;
-    std::string _texKey;
+    friend class CullingSystem;
+
+    const AnimationClip* _clip;
+    int                  _phase;    // frame que muestra en el tiempo 0
+    Transform*           _tr;
+    bool                 _visible;  // lo decide CullingSystem antes de pintar
+    int                  _cullIdx;  // posicion en los arrays de CullingSystem
 };
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 #include "../ecs/Component.h"
 #include "../ecs/Entity.h"
-#include "../sdlutils/SDLUtils.h"
+#include "../game/World.h"
 
 // Cada 5 segundos tiene un 10% de probabilidad de perder 1 unidad de consistencia.
 // Cuando llega a 0, el asteroide muere.
@@ -9,41 +9,48 @@
 struct MaterialConsistency : ecs::Component {
     __CMPID_DECL__(ecs::cmp::MATERIALCONSISTENCY)
 
-        MaterialConsistency() : _consistency(0), _lastCheckTime(0) {
-        // Valor aleatorio entre 10 y 100
-        _consistency = sdlutils().rand().nextInt(10, 101);
+        MaterialConsistency() : _consistency(RANDOM), _timer(TimerWheel::INVALID) {
     }
 
     MaterialConsistency(int consistency)
-        : _consistency(consistency), _lastCheckTime(0) {
+        : _consistency(consistency), _timer(TimerWheel::INVALID) {
     }
 
-    void initComponent() override {
-        _lastCheckTime = sdlutils().virtualTimer().currTime();
+    virtual ~MaterialConsistency() {
+        _ent->getWorld()->timers().cancel(_timer);
     }
 
-    void update() override {
+    void initComponent() override {
+        // Valor aleatorio entre 10 y 100, con los numeros del mundo
+        if (_consistency == RANDOM)
+            _consistency = _ent->getWorld()->rand().nextInt(10, 101);
+
         if (_consistency <= 0) {
             _ent->setAlive(false);
             return;
         }
+        // La comprobacion la hace un timer, no hace falta mirar la hora en
+        // cada update
+        _timer = _ent->getWorld()->timers().schedule(5000, [this]() { check(); }, 5000);
+    }
 
-        // Cada 5 segundos (5000ms) comprobamos con 10% de probabilidad
-        uint32_t now = sdlutils().virtualTimer().currTime();
-        if (now - _lastCheckTime >= 5000u) {
-            _lastCheckTime = now;
-            // 10% de probabilidad de perder 1 unidad
-            if (sdlutils().rand().nextInt(0, 10) == 0) {
-                _consistency--;
-                if (_consistency <= 0)
-                    _ent->setAlive(false);
+    int getConsistency() const { return _consistency; }
+
+private:
+    void check() {
+        // 10% de probabilidad de perder 1 unidad
+        if (_ent->getWorld()->rand().nextInt(0, 10) == 0) {
+            _consistency--;
+            if (_consistency <= 0) {
+                _ent->setAlive(false);
+                _ent->getWorld()->timers().cancel(_timer);
+                _timer = TimerWheel::INVALID;
             }
         }
     }
 
-    int getConsistency() const { return _consistency; }
+    static constexpr int RANDOM = -1;  // aun no se ha elegido
 
-private:
-    int      _consistency;
-    uint32_t _lastCheckTime;
+    int                 _consistency;
+    TimerWheel::TimerId _timer;
 };
\ No newline at end of file
@@ -1,44 +1,35 @@
 #pragma once
+#include <cassert>
 #include "../ecs/Component.h"
 #include "../ecs/Entity.h"
 #include "Transform.h"
-#include "../sdlutils/SDLUtils.h"
-#include "../utils/Vector2D.h"
+#include "../game/World.h"
+#include "../game/BoundsSystem.h"
 
 // Cuando la entidad sale completamente de la pantalla,
 // aparece en una posicion aleatoria en otro borde.
+//
+// La comprobacion la hace BoundsSystem para todas las entidades a la vez
+// (ver vec2batch::outside), el componente solo se registra
 
 struct TeleportOnExit : ecs::Component {
     __CMPID_DECL__(ecs::cmp::TELEPORTONEXIT)
 
-        void update() override {
-        auto* tr = _ent->getComponent<Transform>();
-        if (tr == nullptr) return;
-
-        float x = tr->getPos().getX();
-        float y = tr->getPos().getY();
-        float w = tr->getWidth();
-        float h = tr->getHeight();
-        float sw = (float)sdlutils().width();
-        float sh = (float)sdlutils().height();
+        TeleportOnExit() : _boundsIdx(-1) {}
 
-        bool outLeft = x + w < 0;
-        bool outRight = x > sw;
-        bool outTop = y + h < 0;
-        bool outBottom = y > sh;
+    virtual ~TeleportOnExit() {
+        if (_boundsIdx >= 0)
+            _ent->getWorld()->getBounds()->removeTeleporter(this);
+    }
 
-        if (!outLeft && !outRight && !outTop && !outBottom) return;
+    void initComponent() override {
+        auto* tr = _ent->getComponent<Transform>();
+        assert(tr != nullptr);
+        _ent->getWorld()->getBounds()->addTeleporter(this, tr);
+    }
 
-        auto& rng = sdlutils().rand();
-        int border = rng.nextInt(0, 4);
-        float nx, ny;
-        switch (border) {
-        case 0: nx = (float)rng.nextInt(0, (int)(sw - w)); ny = -h;      break;
-        case 1: nx = (float)rng.nextInt(0, (int)(sw - w)); ny = sh;      break;
-        case 2: nx = -w;  ny = (float)rng.nextInt(0, (int)(sh - h));     break;
-        default:nx = sw;  ny = (float)rng.nextInt(0, (int)(sh - h));     break;
-        }
+private:
+    friend class BoundsSystem;
 
-        tr->getPos() = Vector2D(nx, ny);
-    }
+    int _boundsIdx;  // posicion en los arrays de BoundsSystem
 };
\ No newline at end of file
@@ -1,44 +1,37 @@
 #pragma once
+#include <cassert>
 #include "../ecs/Component.h"
 #include "../ecs/Entity.h"
 #include "Transform.h"
-#include "../sdlutils/SDLUtils.h"
-#include "../utils/Vector2D.h"
+#include "../game/World.h"
+#include "../game/SteeringSystem.h"
+
+// El asteroide se mueve hacia un destino aleatorio y, al llegar (a menos de
+// 5 pixeles), elige otro.
+//
+// El destino y el calculo de la velocidad viven en SteeringSystem (ver
+// SteeringSystem::updateSeekers), el componente solo se registra
 
 struct TowardDestination : ecs::Component {
     __CMPID_DECL__(ecs::cmp::TOWARDDESTINATION)
 
-        TowardDestination() : _speed(0.5f) {}
-    TowardDestination(float speed) : _speed(speed) {}
+        TowardDestination() : _speed(0.5f), _steeringIdx(-1) {}
+    TowardDestination(float speed) : _speed(speed), _steeringIdx(-1) {}
 
-    void initComponent() override {
-        pickNewDestination();
+    virtual ~TowardDestination() {
+        if (_steeringIdx >= 0)
+            _ent->getWorld()->getSteering()->removeSeeker(this);
     }
 
-    void update() override {
+    void initComponent() override {
         auto* tr = _ent->getComponent<Transform>();
-        if (tr == nullptr) return;
-
-        Vector2D p = tr->getPos();
-        Vector2D dir = _dest - p;
-
-        // Si ha llegado al destino, elegir otro
-        if (dir.magnitude() < 5.0f)
-            pickNewDestination();
-
-        // Actualizar velocidad hacia el destino
-        tr->getVel() = dir.normalize() * _speed;
+        assert(tr != nullptr);
+        _ent->getWorld()->getSteering()->addSeeker(this, tr, _speed);
     }
 
 private:
-    void pickNewDestination() {
-        auto& rng = sdlutils().rand();
-        _dest = Vector2D(
-            (float)rng.nextInt(50, sdlutils().width() - 50),
-            (float)rng.nextInt(50, sdlutils().height() - 50)
-        );
-    }
+    friend class SteeringSystem;
 
-    Vector2D _dest;
     float    _speed;
+    int      _steeringIdx;  // posicion en los arrays de SteeringSystem
 };
\ No newline at end of file
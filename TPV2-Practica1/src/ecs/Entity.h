@@ -19,8 +19,9 @@ namespace ecs {
 
 class Entity {
 public:
-	Entity(ecs::grpId_t gId, EntityManager *mngr) :
+	Entity(ecs::grpId_t gId, EntityManager *mngr, World *world) :
 			_mngr(mngr), //
+			_world(world), //
 			_cmps(), //
 			_currCmps(), //
 			_alive(),  //
@@ -55,6 +56,12 @@ public:
 		return _mngr;
 	}
 
+	// Returns the context (the one of the manager) -- components should use
+	// it instead of global objects
+	inline World* getWorld() {
+		return _world;
+	}
+
 	// Setting the state of the entity (alive or dead)
 	//
 	inline void setAlive(bool alive) {
@@ -182,6 +189,7 @@ private:
 	// in which the components are executed is important
 
 	EntityManager *_mngr;
+	World *_world;
 	std::array<Component*, maxComponentId> _cmps;
 	std::vector<Component*> _currCmps;
 	bool _alive;
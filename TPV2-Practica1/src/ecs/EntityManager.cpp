@@ -4,7 +4,8 @@
 
 namespace ecs {
 
-EntityManager::EntityManager() :
+EntityManager::EntityManager(World *world) :
+		_world(world), //
 		_hdlrs(), //
 		_entsByGroup() //
 {
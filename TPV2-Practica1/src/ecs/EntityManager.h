@@ -19,16 +19,22 @@ namespace ecs {
 class EntityManager {
 
 public:
-	EntityManager();
+	// 'world' is the context of the entities of this manager (see
+	// Entity::getWorld), it is not deleted by the manager
+	EntityManager(World *world = nullptr);
 	virtual ~EntityManager();
 
+	inline World* getWorld() {
+		return _world;
+	}
+
 	// Adding an entity simply creates an instance of Entity, adds
 	// it to the list of entities and returns it to the caller.
 	//
 	inline Entity* addEntity(ecs::grpId_t gId = ecs::grp::DEFAULT) {
 
 		// create and initialise the entity
-		auto e = new Entity(gId, this);
+		auto e = new Entity(gId, this, _world);
 		e->setAlive(true);
 
 		// add the entity 'e' to list of entities of the given group
@@ -102,6 +108,7 @@ public:
 
 private:
 
+	World *_world;
 	std::array<Entity*, maxHandlerId> _hdlrs;
 	std::array<std::vector<Entity*>, maxGroupId> _entsByGroup;
 };
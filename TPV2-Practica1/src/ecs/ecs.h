@@ -16,6 +16,12 @@
 #define _HDLRS_LIST_ _HDLR_1
 #endif
 
+// The context in which the entities live (random numbers, time, systems,
+// etc.), defined by the game. The ECS only passes a pointer to it from the
+// manager to its entities, so several managers (each with its own context)
+// can exist at the same time.
+class World;
+
 namespace ecs {
 
 // forward declaration of some classes, to be used when we
@@ -11,23 +11,26 @@
 #include "../components/ImageWithFrames.h"
 #include "../components/Generations.h"
 #include "../components/DisableOnCollision.h"
-#include "../components/WrapAround.h"
+#include "../components/Wraparound.h"
 #include "../components/TeleportOnExit.h"
 #include "../components/Follow.h"
 #include "../components/TowardDestination.h"
 #include "../components/MaterialConsistency.h"
+#include "../components/Flocking.h"
 #include "../sdlutils/SDLUtils.h"
 #include "../utils/Vector2D.h"
+#include "../utils/Vec2Batch.h"
+#include "World.h"
 #include "ecs_defs.h"
 
 class AsteroidsUtils : public AsteroidsFacade {
 public:
-    AsteroidsUtils(ecs::EntityManager* mngr) : mngr_(mngr) {}
+    AsteroidsUtils(World& world) : world_(world), mngr_(world.getMngr()), _positions() {}
     virtual ~AsteroidsUtils() {}
 
     void create_asteroids(int n) override {
         for (int i = 0; i < n; i++) {
-            int gen = sdlutils().rand().nextInt(1, 4);
+            int gen = world_.rand().nextInt(1, 4);
             createAsteroid(gen);
         }
     }
@@ -47,7 +50,7 @@ public:
         a->setAlive(false);
 
         if (g > 1) {
-            auto& rng = sdlutils().rand();
+            auto& rng = world_.rand();
             Vector2D p = tr->getPos();
             Vector2D v = tr->getVel();
             float w = tr->getWidth(), h = tr->getHeight();
@@ -79,22 +82,23 @@ public:
         auto* fTr = fighter->getComponent<Transform>();
         if (fTr == nullptr) return 0.0f;
 
-        Vector2D fPos = fTr->getPos();
-        float minDist = 999999.0f;
+        // Copiar las posiciones a un buffer SoA y calcular el minimo de las
+        // distancias al cuadrado de una vez; solo una raiz al final
+        _positions.clear();
         for (auto* a : mngr_->getEntities(ecs::grp::ASTEROIDS)) {
             if (!a->isAlive()) continue;
             auto* aTr = a->getComponent<Transform>();
             if (aTr == nullptr) continue;
-            float dist = (aTr->getPos() - fPos).magnitude();
-            if (dist < minDist) minDist = dist;
+            _positions.push_back(toVec2(aTr->getPos()));
         }
-        return (minDist < 999999.0f) ? minDist : 0.0f;
+        float minDistSq = vec2batch::minDistanceSq(_positions, toVec2(fTr->getPos()));
+        return (minDistSq >= 0.0f) ? std::sqrt(minDistSq) : 0.0f;
     }
 
 private:
     // Crea el cuerpo base de un asteroide (sin comportamiento ni imagen especial)
     ecs::Entity* createBaseAsteroid(Vector2D pos, Vector2D vel, int gen) {
-        auto& rng = sdlutils().rand();
+        auto& rng = world_.rand();
         // Tamanios visibles: gen1=30, gen2=50, gen3=70
         float size = 20.0f + 25.0f * (float)gen;
 
@@ -113,24 +117,27 @@ private:
         else
             asteroid->addComponent<TeleportOnExit>();
 
+        // Todos se separan de sus vecinos (y se alinean/agrupan un poco)
+        asteroid->addComponent<Flocking>();
+
         return asteroid;
     }
 
     void createAsteroid(int gen) {
-        auto& rng = sdlutils().rand();
+        auto& rng = world_.rand();
 
         // Posicion aleatoria en los bordes
         float ax, ay;
         int border = rng.nextInt(0, 4);
         switch (border) {
-        case 0: ax = (float)rng.nextInt(0, sdlutils().width());  ay = 0.0f; break;
-        case 1: ax = (float)rng.nextInt(0, sdlutils().width());  ay = (float)sdlutils().height(); break;
-        case 2: ax = 0.0f; ay = (float)rng.nextInt(0, sdlutils().height()); break;
-        default: ax = (float)sdlutils().width(); ay = (float)rng.nextInt(0, sdlutils().height()); break;
+        case 0: ax = (float)rng.nextInt(0, (int)world_.width());  ay = 0.0f; break;
+        case 1: ax = (float)rng.nextInt(0, (int)world_.width());  ay = world_.height(); break;
+        case 2: ax = 0.0f; ay = (float)rng.nextInt(0, (int)world_.height()); break;
+        default: ax = world_.width(); ay = (float)rng.nextInt(0, (int)world_.height()); break;
         }
 
-        float cx = sdlutils().width() / 2.0f + (float)rng.nextInt(-100, 101);
-        float cy = sdlutils().height() / 2.0f + (float)rng.nextInt(-100, 101);
+        float cx = world_.width() / 2.0f + (float)rng.nextInt(-100, 101);
+        float cy = world_.height() / 2.0f + (float)rng.nextInt(-100, 101);
 
         Vector2D p(ax, ay);
         float speed = rng.nextInt(1, 11) / 10.0f;
@@ -150,5 +157,7 @@ private:
             asteroid->addComponent<MaterialConsistency>();
     }
 
+    World& world_;
     ecs::EntityManager* mngr_;
+    mutable Vec2Buffer _positions;  // buffer reutilizado por minDistanceToFighter
 };
\ No newline at end of file
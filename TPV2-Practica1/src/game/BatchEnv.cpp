@@ -0,0 +1,163 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "BatchEnv.h"
+#include "World.h"
+#include "FighterUtils.h"
+
+#include <cassert>
+#include "../components/Transform.h"
+#include "../utils/FastRotation.h"
+#include "../utils/ThreadPool.h"
+#include "ecs_defs.h"
+
+BatchEnv::BatchEnv(std::size_t numEnvs, unsigned seed, ThreadPool* pool,
+    float width, float height) :
+    _pool(pool),
+    _worlds(),
+    _destroyed(numEnvs, 0)
+{
+    assert(_pool != nullptr);
+
+    // Cada mundo con un ThreadPool sin hilos: los hilos de _pool ya estan
+    // ocupados con los mundos. Ninguno se pinta, asi que sin particulas
+    _worlds.reserve(numEnvs);
+    for (std::size_t i = 0; i < numEnvs; i++)
+        _worlds.push_back(new World(width, height, seed + (unsigned)i,
+            nullptr, false));
+}
+
+BatchEnv::~BatchEnv() {
+    for (auto* w : _worlds)
+        delete w;
+}
+
+void BatchEnv::reset(float* obs) {
+    _pool->parallelFor(_worlds.size(),
+        [this, obs](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t i = begin; i < end; i++) {
+                resetOne(i);
+                writeObs(i, obs + i * OBS_SIZE);
+            }
+        }, 1);
+}
+
+void BatchEnv::step(const std::uint8_t* actions, float* obs, float* reward,
+    std::uint8_t* done) {
+    _pool->parallelFor(_worlds.size(),
+        [this, actions, obs, reward, done](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t i = begin; i < end; i++)
+                stepOne(i, actions[i], obs, reward, done);
+        }, 1);
+}
+
+void BatchEnv::resetOne(std::size_t i) {
+    World& w = *_worlds[i];
+    w.getFighter()->reset_lives();
+    w.newRound();
+    _destroyed[i] = w.destroyed();
+}
+
+void BatchEnv::stepOne(std::size_t i, std::uint8_t action, float* obs,
+    float* reward, std::uint8_t* done) {
+    World& w = *_worlds[i];
+
+    // La accion son las teclas que leen FighterControl y Gun
+    auto& in = w.input();
+    in.setKeyDown(SDL_SCANCODE_LEFT, (action & ACTION_LEFT) != 0);
+    in.setKeyDown(SDL_SCANCODE_RIGHT, (action & ACTION_RIGHT) != 0);
+    in.setKeyDown(SDL_SCANCODE_UP, (action & ACTION_THRUST) != 0);
+    in.setKeyDown(SDL_SCANCODE_S, (action & ACTION_FIRE) != 0);
+
+    w.advanceClock(World::TICK_MS);
+    World::Event e = w.step();
+
+    float r = (float)(w.destroyed() - _destroyed[i]);
+    bool over = false;
+    if (e == World::FIGHTER_HIT) {
+        r -= 1.0f;
+        over = (w.getFighter()->get_lives() <= 0);
+        if (!over)
+            w.newRound();
+    }
+    else if (e == World::NO_ASTEROIDS) {
+        over = true;
+    }
+
+    if (over)
+        resetOne(i);
+    else
+        _destroyed[i] = w.destroyed();
+
+    reward[i] = r;
+    done[i] = over ? 1 : 0;
+    writeObs(i, obs + i * OBS_SIZE);
+}
+
+// Fila de la observacion (OBS_SIZE floats):
+//
+//  [0..5]  caza: centro (x/ancho, y/alto), velocidad (x,y), seno y coseno
+//          de la rotacion,
+//  [6..]   NEAREST asteroides, del mas cercano al mas lejano: posicion del
+//          centro relativa a la del caza (x/ancho, y/alto) y velocidad
+//          (x,y). Si hay menos, el resto son ceros.
+//
+// Los mas cercanos se buscan con una insercion en un array fijo, sin
+// reservar memoria.
+
+void BatchEnv::writeObs(std::size_t i, float* obs) {
+    World& w = *_worlds[i];
+    float invW = 1.0f / w.width();
+    float invH = 1.0f / w.height();
+
+    for (std::size_t k = 0; k < OBS_SIZE; k++)
+        obs[k] = 0.0f;
+
+    auto* mngr = w.getMngr();
+    auto* fighter = mngr->getHandler(ecs::hdlr::FIGHTER_HDLR);
+    if (fighter == nullptr) return;
+    auto* fTr = fighter->getComponent<Transform>();
+    if (fTr == nullptr) return;
+
+    float fx = fTr->getPos().getX() + fTr->getWidth() * 0.5f;
+    float fy = fTr->getPos().getY() + fTr->getHeight() * 0.5f;
+    SinCos sc = SinCos::fromDegrees(fTr->getRot());
+    obs[0] = fx * invW;
+    obs[1] = fy * invH;
+    obs[2] = fTr->getVel().getX();
+    obs[3] = fTr->getVel().getY();
+    obs[4] = sc.sin;
+    obs[5] = sc.cos;
+
+    // Los NEAREST mas cercanos, ordenados por distancia al cuadrado
+    float nearDist[NEAREST];
+    Transform* nearTr[NEAREST];
+    std::size_t n = 0;
+    for (auto* a : mngr->getEntities(ecs::grp::ASTEROIDS)) {
+        if (!a->isAlive()) continue;
+        auto* aTr = a->getComponent<Transform>();
+        if (aTr == nullptr) continue;
+
+        float dx = aTr->getPos().getX() + aTr->getWidth() * 0.5f - fx;
+        float dy = aTr->getPos().getY() + aTr->getHeight() * 0.5f - fy;
+        float d = dx * dx + dy * dy;
+        if (n == NEAREST && d >= nearDist[n - 1]) continue;
+
+        std::size_t j = (n < NEAREST) ? n++ : n - 1;
+        while (j > 0 && nearDist[j - 1] > d) {
+            nearDist[j] = nearDist[j - 1];
+            nearTr[j] = nearTr[j - 1];
+            j--;
+        }
+        nearDist[j] = d;
+        nearTr[j] = aTr;
+    }
+
+    float* out = obs + 6;
+    for (std::size_t k = 0; k < n; k++, out += 4) {
+        Transform* aTr = nearTr[k];
+        out[0] = (aTr->getPos().getX() + aTr->getWidth() * 0.5f - fx) * invW;
+        out[1] = (aTr->getPos().getY() + aTr->getHeight() * 0.5f - fy) * invH;
+        out[2] = aTr->getVel().getX();
+        out[3] = aTr->getVel().getY();
+    }
+}
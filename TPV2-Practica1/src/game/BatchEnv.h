@@ -0,0 +1,72 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+class World;
+class Transform;
+
+// K partidas sin ventana que avanzan un tick todas a la vez, para entrenar
+// bots. Cada una es un World propio (con su semilla), y step() las reparte
+// entre los hilos del ThreadPool: cada hilo solo toca los mundos de su
+// trozo y sus filas de los buffers, asi que no hay nada que sincronizar.
+//
+// Entrada y salida van en buffers contiguos que da quien llama, una fila
+// por partida:
+//
+//  - actions[K]: bits de ACTION_* (las teclas que se pulsan en ese tick),
+//  - obs[K * OBS_SIZE]: ver writeObs(); se escribe directamente desde los
+//    Transform del caza y de los NEAREST asteroides mas cercanos,
+//  - reward[K]: asteroides destruidos en el tick, -1 si el caza ha perdido
+//    una vida,
+//  - done[K]: 1 si la partida ha terminado (sin vidas o sin asteroides).
+//    Esa partida se reinicia sola y obs ya es la del principio de la nueva.
+//
+// Los recursos (imagenes, sonidos) son los de sdlutils(), que tiene que
+// estar inicializado sin ventana (SDLUtils::headless) para que los sonidos
+// no suenen desde varios hilos.
+
+class BatchEnv {
+public:
+    enum Action : std::uint8_t {
+        ACTION_LEFT = 1,
+        ACTION_RIGHT = 2,
+        ACTION_THRUST = 4,
+        ACTION_FIRE = 8
+    };
+
+    static constexpr std::size_t NEAREST = 8;  // asteroides en la observacion
+    static constexpr std::size_t OBS_SIZE = 6 + 4 * NEAREST;
+
+    // 'pool' se comparte y no se borra
+    BatchEnv(std::size_t numEnvs, unsigned seed, ThreadPool* pool,
+        float width = 800.0f, float height = 600.0f);
+    virtual ~BatchEnv();
+
+    BatchEnv(const BatchEnv&) = delete;
+    BatchEnv& operator=(const BatchEnv&) = delete;
+
+    inline std::size_t size() const { return _worlds.size(); }
+
+    // Empieza una partida nueva en todas y escribe la observacion inicial
+    void reset(float* obs);
+
+    // Un tick (World::TICK_MS) en cada partida
+    void step(const std::uint8_t* actions, float* obs, float* reward,
+        std::uint8_t* done);
+
+    inline World* getWorld(std::size_t i) { return _worlds[i]; }
+
+private:
+    void resetOne(std::size_t i);
+    void stepOne(std::size_t i, std::uint8_t action, float* obs,
+        float* reward, std::uint8_t* done);
+    void writeObs(std::size_t i, float* obs);
+
+    ThreadPool* _pool;
+    std::vector<World*> _worlds;
+    std::vector<unsigned long> _destroyed;  // World::destroyed() del tick anterior
+};
@@ -0,0 +1,133 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "BoundsSystem.h"
+
+#include <cassert>
+#include "../components/Transform.h"
+#include "../components/Wraparound.h"
+#include "../components/TeleportOnExit.h"
+#include "World.h"
+
+BoundsSystem::BoundsSystem(World& world) :
+    _world(world),
+    _width(world.width()),
+    _height(world.height()),
+    _wrappers(),
+    _wrapperCmps(),
+    _teleporters(),
+    _teleporterCmps(),
+    _pos(),
+    _size(),
+    _out()
+{
+}
+
+BoundsSystem::~BoundsSystem() {
+}
+
+// ---- Registro ----
+//
+// Como en SteeringSystem: se borra moviendo el ultimo al hueco y
+// actualizando el indice que guarda su componente.
+
+template<typename T>
+static void swapPop(std::vector<T>& v, std::size_t i) {
+    v[i] = v.back();
+    v.pop_back();
+}
+
+void BoundsSystem::addWrapper(WrapAround* w, Transform* tr) {
+    assert(w->_boundsIdx < 0);
+    w->_boundsIdx = (int)_wrappers.size();
+    _wrappers.push_back(tr);
+    _wrapperCmps.push_back(w);
+}
+
+void BoundsSystem::removeWrapper(WrapAround* w) {
+    int i = w->_boundsIdx;
+    assert(i >= 0 && _wrapperCmps[i] == w);
+    swapPop(_wrappers, i);
+    swapPop(_wrapperCmps, i);
+    if (i < (int)_wrappers.size())
+        _wrapperCmps[i]->_boundsIdx = i;
+    w->_boundsIdx = -1;
+}
+
+void BoundsSystem::addTeleporter(TeleportOnExit* t, Transform* tr) {
+    assert(t->_boundsIdx < 0);
+    t->_boundsIdx = (int)_teleporters.size();
+    _teleporters.push_back(tr);
+    _teleporterCmps.push_back(t);
+}
+
+void BoundsSystem::removeTeleporter(TeleportOnExit* t) {
+    int i = t->_boundsIdx;
+    assert(i >= 0 && _teleporterCmps[i] == t);
+    swapPop(_teleporters, i);
+    swapPop(_teleporterCmps, i);
+    if (i < (int)_teleporters.size())
+        _teleporterCmps[i]->_boundsIdx = i;
+    t->_boundsIdx = -1;
+}
+
+// ---- Update ----
+
+void BoundsSystem::update() {
+    updateWrappers();
+    updateTeleporters();
+}
+
+void BoundsSystem::updateWrappers() {
+    std::size_t n = _wrappers.size();
+    if (n == 0) return;
+
+    _pos.resize(n);
+    _size.resize(n);
+    Vec2Span pos = _pos.span();
+    Vec2Span size = _size.span();
+    for (std::size_t i = 0; i < n; i++) {
+        Transform* tr = _wrappers[i];
+        pos.set(i, toVec2(tr->getPos()));
+        size.set(i, Vec2(tr->getWidth(), tr->getHeight()));
+    }
+
+    vec2batch::wrap(pos, size, Vec2(_width, _height));
+
+    for (std::size_t i = 0; i < n; i++)
+        _wrappers[i]->getPos() = toVector2D(pos[i]);
+}
+
+void BoundsSystem::updateTeleporters() {
+    std::size_t n = _teleporters.size();
+    if (n == 0) return;
+
+    _pos.resize(n);
+    _size.resize(n);
+    _out.resize(n);
+    Vec2Span pos = _pos.span();
+    Vec2Span size = _size.span();
+    for (std::size_t i = 0; i < n; i++) {
+        Transform* tr = _teleporters[i];
+        pos.set(i, toVec2(tr->getPos()));
+        size.set(i, Vec2(tr->getWidth(), tr->getHeight()));
+    }
+
+    std::size_t k = vec2batch::outside(_out.data(), pos, size,
+        Vec2(_width, _height));
+
+    // Aparece en un borde aleatorio, fuera de la pantalla
+    auto& rng = _world.rand();
+    for (std::size_t j = 0; j < k; j++) {
+        std::uint32_t i = _out[j];
+        float w = size.x[i];
+        float h = size.y[i];
+        float nx, ny;
+        switch (rng.nextInt(0, 4)) {
+        case 0: nx = (float)rng.nextInt(0, (int)(_width - w)); ny = -h;       break;
+        case 1: nx = (float)rng.nextInt(0, (int)(_width - w)); ny = _height;  break;
+        case 2: nx = -w;      ny = (float)rng.nextInt(0, (int)(_height - h)); break;
+        default:nx = _width;  ny = (float)rng.nextInt(0, (int)(_height - h)); break;
+        }
+        _teleporters[i]->getPos() = Vector2D(nx, ny);
+    }
+}
@@ -0,0 +1,68 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../utils/Vec2Batch.h"
+
+class Transform;
+class World;
+struct WrapAround;
+struct TeleportOnExit;
+
+// Sistema que comprueba de una vez si las entidades con WrapAround o
+// TeleportOnExit han salido de la pantalla. Los componentes solo se
+// registran (initComponent) y se dan de baja (destructor), como los de
+// SteeringSystem.
+//
+// El tamanio del mundo se lee una vez, al crear el sistema. En cada
+// tick:
+//
+//  - WrapAround: se copian posiciones y tamanios a arrays SoA, se pasan
+//    todos por vec2batch::wrap (sin saltos, de 4 en 4) y se escriben de
+//    vuelta,
+//  - TeleportOnExit: vec2batch::outside da la lista (casi siempre vacia)
+//    de los que han salido del todo, y solo esos se colocan en un borde
+//    aleatorio.
+//
+// Se llama justo despues de EntityManager::update(), cuando las entidades
+// ya se han movido, que es cuando lo hacian los componentes (eran los
+// ultimos de cada entidad).
+
+class BoundsSystem {
+public:
+    BoundsSystem(World& world);
+    virtual ~BoundsSystem();
+
+    void addWrapper(WrapAround* w, Transform* tr);
+    void removeWrapper(WrapAround* w);
+
+    void addTeleporter(TeleportOnExit* t, Transform* tr);
+    void removeTeleporter(TeleportOnExit* t);
+
+    void update();
+
+    std::size_t numWrappers() const { return _wrappers.size(); }
+    std::size_t numTeleporters() const { return _teleporters.size(); }
+
+private:
+    void updateWrappers();
+    void updateTeleporters();
+
+    World& _world;
+
+    float _width;   // del mundo
+    float _height;
+
+    std::vector<Transform*>  _wrappers;
+    std::vector<WrapAround*> _wrapperCmps;
+
+    std::vector<Transform*>      _teleporters;
+    std::vector<TeleportOnExit*> _teleporterCmps;
+
+    // buffers reutilizados en cada tick
+    Vec2Buffer                 _pos;
+    Vec2Buffer                 _size;
+    std::vector<std::uint32_t> _out;
+};
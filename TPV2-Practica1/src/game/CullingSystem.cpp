@@ -0,0 +1,105 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "CullingSystem.h"
+
+#include <cassert>
+#include <cmath>
+#include "../components/Transform.h"
+#include "../components/Image.h"
+#include "../components/ImageWithFrames.h"
+#include "World.h"
+
+CullingSystem::CullingSystem(World& world) :
+    _width(world.width()),
+    _height(world.height()),
+    _trs(),
+    _visible(),
+    _idx(),
+    _pos(),
+    _size(),
+    _out(),
+    _numCulled(0)
+{
+}
+
+CullingSystem::~CullingSystem() {
+}
+
+// ---- Registro ----
+//
+// Como en BoundsSystem: se borra moviendo el ultimo al hueco y
+// actualizando el indice que guarda su componente.
+
+void CullingSystem::addImage(Image* img, Transform* tr) {
+    add(tr, &img->_visible, &img->_cullIdx);
+}
+
+void CullingSystem::removeImage(Image* img) {
+    remove(&img->_cullIdx);
+}
+
+void CullingSystem::addAnimated(ImageWithFrames* img, Transform* tr) {
+    add(tr, &img->_visible, &img->_cullIdx);
+}
+
+void CullingSystem::removeAnimated(ImageWithFrames* img) {
+    remove(&img->_cullIdx);
+}
+
+void CullingSystem::add(Transform* tr, bool* visible, int* idx) {
+    assert(*idx < 0);
+    *idx = (int)_trs.size();
+    *visible = true;
+    _trs.push_back(tr);
+    _visible.push_back(visible);
+    _idx.push_back(idx);
+}
+
+void CullingSystem::remove(int* idx) {
+    int i = *idx;
+    assert(i >= 0 && _idx[i] == idx);
+    _trs[i] = _trs.back();
+    _visible[i] = _visible.back();
+    _idx[i] = _idx.back();
+    _trs.pop_back();
+    _visible.pop_back();
+    _idx.pop_back();
+    if (i < (int)_trs.size())
+        *_idx[i] = i;
+    *idx = -1;
+}
+
+// ---- Update ----
+
+void CullingSystem::update() {
+    std::size_t n = _trs.size();
+    _numCulled = 0;
+    if (n == 0) return;
+
+    _pos.resize(n);
+    _size.resize(n);
+    _out.resize(n);
+    Vec2Span pos = _pos.span();
+    Vec2Span size = _size.span();
+    for (std::size_t i = 0; i < n; i++) {
+        Transform* tr = _trs[i];
+        float x = tr->getPos().getX(), y = tr->getPos().getY();
+        float w = tr->getWidth(), h = tr->getHeight();
+
+        // Girado, la caja es la del circulo que lo contiene (mismo centro)
+        if (tr->getRot() != 0.0f) {
+            float r = 0.5f * std::sqrt(w * w + h * h);
+            x += 0.5f * w - r;
+            y += 0.5f * h - r;
+            w = h = 2.0f * r;
+        }
+        pos.set(i, Vec2(x, y));
+        size.set(i, Vec2(w, h));
+        *_visible[i] = true;
+    }
+
+    _numCulled = vec2batch::outside(_out.data(), pos, size,
+        Vec2(_width, _height));
+    for (std::size_t j = 0; j < _numCulled; j++)
+        *_visible[_out[j]] = false;
+}
@@ -0,0 +1,61 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../utils/Vec2Batch.h"
+
+class Transform;
+class World;
+class Image;
+struct ImageWithFrames;
+
+// Sistema que decide, antes de pintar, que entidades se ven. Image e
+// ImageWithFrames se registran (initComponent) y se dan de baja
+// (destructor), como los componentes de BoundsSystem, y en su render()
+// solo miran el flag que les deja este sistema: si estan fuera de la
+// pantalla no llegan a hacer ninguna llamada a SDL (ni al SpriteBatch).
+//
+// update() se llama justo antes de EntityManager::render(): copia la caja
+// de cada entidad (la del Transform, agrandada para que contenga la
+// rotacion si la hay) a arrays SoA, y vec2batch::outside da de una vez
+// las que estan completamente fuera de la pantalla. El resto se pinta, en
+// el orden de siempre.
+//
+// Los TeleportOnExit pasan mucho tiempo fuera de la pantalla, y los
+// WrapAround salen del todo antes de aparecer por el otro lado.
+
+class CullingSystem {
+public:
+    CullingSystem(World& world);
+    virtual ~CullingSystem();
+
+    void addImage(Image* img, Transform* tr);
+    void removeImage(Image* img);
+
+    void addAnimated(ImageWithFrames* img, Transform* tr);
+    void removeAnimated(ImageWithFrames* img);
+
+    void update();
+
+    std::size_t numRenderables() const { return _trs.size(); }
+    std::size_t numCulled() const { return _numCulled; }
+
+private:
+    void add(Transform* tr, bool* visible, int* idx);
+    void remove(int* idx);
+
+    float _width;   // del mundo (la pantalla)
+    float _height;
+
+    std::vector<Transform*> _trs;
+    std::vector<bool*>      _visible;  // flag del componente
+    std::vector<int*>       _idx;      // donde guarda el componente su posicion
+
+    // buffers reutilizados en cada frame
+    Vec2Buffer                 _pos;
+    Vec2Buffer                 _size;
+    std::vector<std::uint32_t> _out;
+    std::size_t                _numCulled;
+};
@@ -10,22 +10,23 @@
 #include "../components/FighterControl.h"
 #include "../components/Gun.h"
 #include "../components/Health.h"
-#include "../components/WrapAround.h"
+#include "../components/Wraparound.h"
 #include "../sdlutils/SDLUtils.h"
 #include "../utils/Vector2D.h"
+#include "World.h"
 #include "ecs_defs.h"
 
 class FighterUtils : public FighterFacade {
 public:
-    FighterUtils(ecs::EntityManager* mngr) : mngr_(mngr) {}
+    FighterUtils(World& world) : world_(world), mngr_(world.getMngr()) {}
     virtual ~FighterUtils() {}
 
     void create_fighter() override {
         auto* fighter = mngr_->addEntity(ecs::grp::FIGHTER);
 
         float fw = 40.0f, fh = 40.0f;
-        float fx = (sdlutils().width() - fw) / 2.0f;
-        float fy = (sdlutils().height() - fh) / 2.0f;
+        float fx = (world_.width() - fw) / 2.0f;
+        float fy = (world_.height() - fh) / 2.0f;
 
         fighter->addComponent<Transform>(
             Vector2D(fx, fy), Vector2D(0.0f, 0.0f), fw, fh, 0.0f
@@ -49,8 +50,8 @@ public:
         if (tr != nullptr) {
             float fw = tr->getWidth(), fh = tr->getHeight();
             tr->getPos() = Vector2D(
-                (sdlutils().width() - fw) / 2.0f,
-                (sdlutils().height() - fh) / 2.0f
+                (world_.width() - fw) / 2.0f,
+                (world_.height() - fh) / 2.0f
             );
             tr->getVel() = Vector2D(0.0f, 0.0f);
             tr->setRot(0.0f);
@@ -88,5 +89,6 @@ public:
     }
 
 private:
+    World& world_;
     ecs::EntityManager* mngr_;
 };
\ No newline at end of file
@@ -2,33 +2,36 @@
 
 #include "Game.h"
 #include "GameStates.h"
-#include "FighterUtils.h"
-#include "AsteroidsUtils.h"
+#include "World.h"
+#include "BatchEnv.h"
 
 #include <iostream>
-#include "../components/Transform.h"
-#include "../components/Gun.h"
-#include "../components/Health.h"
-#include "../components/Generations.h"
-#include "../components/DisableOnCollision.h"
-#include "../ecs/EntityManager.h"
+#include <string>
+#include <thread>
+#include <vector>
 #include "../sdlutils/InputHandler.h"
 #include "../sdlutils/SDLUtils.h"
-#include "../utils/Vector2D.h"
-#include "../utils/Collisions.h"
-#include "ecs_defs.h"
+#include "../utils/ThreadPool.h"
 
 Game::Game() :
-    mngr_(nullptr),
+    _world(nullptr),
+    _pool(nullptr),
     _state(nullptr),
     _running_state(nullptr),
     _paused_state(nullptr),
     _newgame_state(nullptr),
     _newround_state(nullptr),
     _gameover_state(nullptr),
-    _fu(nullptr),
-    _au(nullptr),
-    _stateChanged(false)
+    _stateChanged(false),
+    _renderTick(true),
+    _thread(),
+    _frameMutex(),
+    _frameCV(),
+    _frameReq(false),
+    _frameTicks(0),
+    _frameDone(false),
+    _quit(false),
+    _pacer()
 {
 }
 
@@ -38,16 +41,15 @@ Game::~Game() {
     delete _newgame_state;
     delete _newround_state;
     delete _gameover_state;
-    delete _fu;
-    delete _au;
-    delete mngr_;
+    delete _world;
+    delete _pool;  // despues de _world, que lo usa
     if (InputHandler::HasInstance()) InputHandler::Release();
     if (SDLUtils::HasInstance())     SDLUtils::Release();
 }
 
-bool Game::init() {
-    if (!SDLUtils::Init("Asteroids", 800, 600,
-        "resources/config/asteroid.resources.json")) {
+bool Game::init(bool headless, int width, int height) {
+    // Sin fichero: los recursos se cargan despues, con pantalla de carga
+    if (!SDLUtils::Init("Asteroids", width, height, std::string(), headless)) {
         std::cerr << "Error inicializando SDLUtils" << std::endl;
         return false;
     }
@@ -55,22 +57,44 @@ bool Game::init() {
         std::cerr << "Error inicializando InputHandler" << std::endl;
         return false;
     }
-    sdlutils().showCursor();
+    sdlutils().startLoading(RESOURCES);
+    showLoading();
+    if (!headless)
+        sdlutils().showCursor();
     return true;
 }
 
-void Game::initGame() {
-    mngr_ = new ecs::EntityManager();
-    _fu = new FighterUtils(mngr_);
-    _au = new AsteroidsUtils(mngr_);
+void Game::showLoading() {
+    auto& sdl = sdlutils();
+
+    // Cada vuelta espera como mucho un frame a que haya algo cargado, crea
+    // sus texturas (aqui, que es el hilo del renderer) y pinta la barra. En
+    // headless no hay nada que esperar: ya esta todo cargado
+    while (!sdl.updateLoading(16)) {
+        ih().refresh();  // que la ventana no deje de responder
+
+        float w = sdl.width() * 0.5f, h = 16.0f;
+        SDL_FRect bar{ (sdl.width() - w) * 0.5f, (sdl.height() - h) * 0.5f, w, h };
+        SDL_FRect done{ bar.x, bar.y, w * sdl.loadingProgress(), h };
 
-    _fu->create_fighter();
+        sdl.clearRenderer(build_sdlcolor(0x000000FF));
+        SDL_SetRenderDrawColor(sdl.renderer(), 0xff, 0xff, 0xff, 0xff);
+        SDL_RenderFillRect(sdl.renderer(), &done);
+        SDL_RenderRect(sdl.renderer(), &bar);
+        sdl.presentRenderer();
+    }
+}
 
-    _running_state = new RunningState(this, _fu, _au);
-    _paused_state = new PausedState(this, _fu, _au);
-    _newgame_state = new NewGameState(this, _fu, _au);
-    _newround_state = new NewRoundState(this, _fu, _au);
-    _gameover_state = new GameOverState(this, _fu, _au);
+void Game::initGame() {
+    _pool = new ThreadPool();
+    _world = new World((float)sdlutils().width(), (float)sdlutils().height(),
+        (unsigned)sdlutils().rand().nextInt(0, 0x7fffffff), _pool);
+
+    _running_state = new RunningState(this, _world);
+    _paused_state = new PausedState(this, _world);
+    _newgame_state = new NewGameState(this, _world);
+    _newround_state = new NewRoundState(this, _world);
+    _gameover_state = new GameOverState(this, _world);
 
     _state = _newgame_state;
     _state->enter();
@@ -92,85 +116,201 @@ void Game::setState(State s) {
 void Game::start() {
     bool exit = false;
     auto& ihdlr = ih();
-    auto& vt = sdlutils().virtualTimer();
-    vt.resetTime();
+    _world->clock().resetTime();
+
+    _quit = false;
+    _thread = std::thread(&Game::gameThread, this);
+
+    // La simulacion va a ticks fijos de TICK_MS, sea cual sea el ritmo de
+    // los frames: en cada frame se hacen los ticks que tocan por el tiempo
+    // que ha pasado (0 si los frames van mas rapido que los ticks)
+    const Uint64 tickNS = (Uint64)TICK_MS * 1000000;
+    Uint64 pending = tickNS;  // el primer frame hace un tick
+    Uint64 last = SDL_GetTicksNS();
+    _pacer.start();
 
     while (!exit) {
-        // Registrar el tiempo real actual en el timer virtual
-        Uint32 startTime = (Uint32)vt.regCurrTime();
-        ihdlr.refresh();
+
+        // La entrada global se copia al mundo, que es de donde la leen los
+        // componentes. El hilo del juego esta parado: la entrada y el mundo
+        // solo se tocan aqui entre frames.
+        //
+        // Los eventos de teclado y raton no se borran aqui sino en el hilo
+        // del juego, despues de su primer tick: en un frame sin ticks nadie
+        // los ha visto, y se acumulan con los del siguiente (si no, p.ej.
+        // una tecla pulsada en ese frame no saldria de la pausa)
+        ihdlr.refresh(true);
+        _world->input().capture(ihdlr);
+
+        // Registrar el tiempo real actual en el reloj virtual del mundo (y
+        // mover sus timers, que se paran en la pausa)
+        _world->advanceClock();
 
         if (ihdlr.isKeyDown(SDL_SCANCODE_ESCAPE)) {
             exit = true;
             continue;
         }
 
-        _stateChanged = false;
-        _state->update();
+        // Se ha perdido lo que habia en las capas guardadas y en las
+        // imagenes pre-rotadas
+        if (ihdlr.renderTargetsResetEvent())
+            sdlutils().renderTargetsReset();
 
-        Uint32 frameTime = (Uint32)vt.currTime() - startTime;
-        if (frameTime < 10)
-            SDL_Delay(10 - frameTime);
+        Uint64 now = SDL_GetTicksNS();
+        pending += now - last;
+        last = now;
+        int ticks = (int)(pending / tickNS);
+        pending -= (Uint64)ticks * tickNS;
+        if (ticks > MAX_TICKS_PER_FRAME)
+            ticks = MAX_TICKS_PER_FRAME;  // muy atrasados: se pierde tiempo
+
+        // El hilo del juego graba este frame mientras aqui se pinta el
+        // anterior (si ha grabado uno: los estados que cambian no lo hacen)
+        if (ticks > 0)
+            runFrame(ticks);
+        if (RenderList* cmds = sdlutils().renderQueue().acquire())
+            sdlutils().presentCommands(*cmds);
+        if (ticks > 0)
+            waitFrame();
+
+        // Con el hilo del juego parado y el frame anterior ya pintado: se
+        // cargan las texturas que ha pedido y se descarga lo que sobra
+        sdlutils().updateResidency();
+
+        _pacer.endFrame();
     }
+
+    {
+        std::lock_guard<std::mutex> lock(_frameMutex);
+        _quit = true;
+    }
+    _frameCV.notify_all();
+    _thread.join();
+
+    _pacer.histogram().dump(std::cout);
+    sdlutils().dumpResidency(std::cout);
 }
 
-void Game::checkCollisions() {
-    auto* fighter = mngr_->getHandler(ecs::hdlr::FIGHTER_HDLR);
-    if (fighter == nullptr || !fighter->isAlive()) return;
-
-    auto* fighterTr = fighter->getComponent<Transform>();
-    auto* fighterGun = fighter->getComponent<Gun>();
-    if (fighterTr == nullptr) return;
-
-    auto& asteroids = mngr_->getEntities(ecs::grp::ASTEROIDS);
-
-    // --- Balas vs Asteroides ---
-    if (fighterGun != nullptr) {
-        for (auto& bullet : *fighterGun) {
-            if (!bullet.used) continue;
-            for (auto* asteroid : asteroids) {
-                if (!asteroid->isAlive()) continue;
-                auto* asTr = asteroid->getComponent<Transform>();
-                if (asTr == nullptr) continue;
-
-                bool hit = Collisions::collidesWithRotation(
-                    bullet.pos, (float)bullet.width, (float)bullet.height, bullet.rot,
-                    asTr->getPos(), asTr->getWidth(), asTr->getHeight(), 0.0f
-                );
-
-                if (hit) {
-                    bullet.used = false;
-                    _au->split_astroid(asteroid);
-                    sdlutils().soundEffects().at("explosion").play();
-                    break;
-                }
-            }
+void Game::setPacing(FramePacer::Mode mode, int fps) {
+    _pacer.setMode(mode, fps, sdlutils().renderer());
+}
+
+// ---- Hilo del juego ----
+
+void Game::gameThread() {
+    std::unique_lock<std::mutex> lock(_frameMutex);
+    for (;;) {
+        _frameCV.wait(lock, [this]() { return _frameReq || _quit; });
+        if (_quit) return;
+        _frameReq = false;
+        int ticks = _frameTicks;
+        lock.unlock();
+
+        // Si hay mas de un tick, solo el ultimo graba el frame. Los eventos
+        // (tecla pulsada...) son del primero: si no, los siguientes ticks
+        // verian otra vez la misma pulsacion (p.ej. pausar y volver a la
+        // partida en el mismo frame). Es el unico sitio donde se borran: el
+        // hilo principal los va acumulando hasta que un frame tenga ticks
+        for (int i = 0; i < ticks; i++) {
+            _stateChanged = false;
+            _renderTick = (i == ticks - 1);
+            _state->update();
+            if (i == 0)
+                ih().clearState();
         }
+
+        lock.lock();
+        _frameDone = true;
+        _frameCV.notify_all();
     }
+}
+
+void Game::runFrame(int ticks) {
+    {
+        std::lock_guard<std::mutex> lock(_frameMutex);
+        _frameReq = true;
+        _frameTicks = ticks;
+        _frameDone = false;
+    }
+    _frameCV.notify_all();
+}
+
+void Game::waitFrame() {
+    std::unique_lock<std::mutex> lock(_frameMutex);
+    _frameCV.wait(lock, [this]() { return _frameDone; });
+}
 
-    // Si el estado cambio durante las colisiones de balas, salir
-    if (_stateChanged) return;
-
-    // --- Caza vs Asteroides ---
-    for (auto* asteroid : asteroids) {
-        if (!asteroid->isAlive()) continue;
-        auto* asTr = asteroid->getComponent<Transform>();
-        if (asTr == nullptr) continue;
-
-        bool hit = Collisions::collidesWithRotation(
-            fighterTr->getPos(), fighterTr->getWidth(), fighterTr->getHeight(), fighterTr->getRot(),
-            asTr->getPos(), asTr->getWidth(), asTr->getHeight(), 0.0f
-        );
-
-        if (hit) {
-            asteroid->setAlive(false);
-            sdlutils().soundEffects().at("explosion").play();
-            int livesLeft = _fu->update_lives(-1);
-            if (livesLeft <= 0)
-                setState(GAMEOVER);
-            else
-                setState(NEWROUND);
-            return;  // salir inmediatamente, no tocar mas entidades
+void Game::startHeadless(unsigned long ticks, int worlds, unsigned seed) {
+    if (worlds < 1) worlds = 1;
+
+    // Cada mundo con su semilla y su ThreadPool sin hilos: el paralelismo
+    // esta en que cada mundo va en su hilo. No se pintan, asi que no tienen
+    // particulas
+    std::vector<World*> ws;
+    for (int i = 0; i < worlds; i++)
+        ws.push_back(new World((float)sdlutils().width(), (float)sdlutils().height(),
+            seed + (unsigned)i, nullptr, false));
+    std::vector<unsigned long> rounds(worlds, 0);
+
+    Uint64 startNS = SDL_GetTicksNS();
+
+    if (worlds == 1) {
+        rounds[0] = ws[0]->simulate(ticks);
+    }
+    else {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < worlds; i++)
+            threads.emplace_back([&ws, &rounds, i, ticks]() {
+                rounds[i] = ws[i]->simulate(ticks);
+            });
+        for (auto& t : threads)
+            t.join();
+    }
+
+    double secs = (SDL_GetTicksNS() - startNS) / 1e9;
+    unsigned long total = ticks * (unsigned long)worlds;
+    for (int i = 0; i < worlds; i++)
+        std::cout << "world " << i << " (seed " << seed + (unsigned)i << "): "
+            << rounds[i] << " rounds" << std::endl;
+    std::cout << total << " ticks in " << secs << " s, "
+        << (secs > 0.0 ? total / secs : 0.0) << " ticks/s" << std::endl;
+
+    for (auto* w : ws)
+        delete w;
+}
+
+void Game::startBatchEnv(unsigned long ticks, int envs, unsigned seed) {
+    if (envs < 1) envs = 1;
+
+    BatchEnv env((std::size_t)envs, seed, _pool,
+        (float)sdlutils().width(), (float)sdlutils().height());
+
+    std::vector<std::uint8_t> actions(envs);
+    std::vector<float> obs(envs * BatchEnv::OBS_SIZE);
+    std::vector<float> reward(envs);
+    std::vector<std::uint8_t> done(envs);
+    RandomNumberGenerator rng(seed);
+
+    env.reset(obs.data());
+
+    unsigned long games = 0;
+    double totalReward = 0.0;
+    Uint64 startNS = SDL_GetTicksNS();
+
+    for (unsigned long t = 0; t < ticks; t++) {
+        for (auto& a : actions)
+            a = (std::uint8_t)rng.nextInt(0, 16);
+        env.step(actions.data(), obs.data(), reward.data(), done.data());
+        for (int i = 0; i < envs; i++) {
+            totalReward += reward[i];
+            games += done[i];
         }
     }
+
+    double secs = (SDL_GetTicksNS() - startNS) / 1e9;
+    unsigned long total = ticks * (unsigned long)envs;
+    std::cout << envs << " envs, " << games << " games, reward " << totalReward
+        << std::endl;
+    std::cout << total << " steps in " << secs << " s, "
+        << (secs > 0.0 ? total / secs : 0.0) << " steps/s" << std::endl;
 }
\ No newline at end of file
@@ -2,12 +2,16 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "../sdlutils/FramePacer.h"
 #include "../utils/Singleton.h"
-#include "../ecs/EntityManager.h"
 
 class GameState;
-class FighterUtils;
-class AsteroidsUtils;
+class RunningState;
+class ThreadPool;
+class World;
 
 class Game : public Singleton<Game> {
     friend Singleton<Game>;
@@ -15,11 +19,45 @@ class Game : public Singleton<Game> {
 public:
     virtual ~Game();
 
-    bool init();
+    // headless: sin ventana, render ni audio (ver SDLUtils::headless), y
+    // (width,height) son solo el tamanio del mundo
+    bool init(bool headless = false, int width = 800, int height = 600);
     void initGame();
+
+    // Bucle principal. La logica de los estados va en un hilo propio (el
+    // del juego), que graba cada frame como una lista de comandos; el hilo
+    // principal lee la entrada y pinta el frame anterior mientras tanto, asi
+    // que las esperas del vsync y del driver no le quitan tiempo a la
+    // simulacion. SDL solo se usa desde el hilo principal.
+    //
+    // La simulacion va siempre a ticks de TICK_MS; el ritmo de los frames
+    // lo pone el FramePacer (ver setPacing), y al salir se escribe el
+    // histograma de los tiempos de frame.
     void start();
 
-    inline ecs::EntityManager* getMngr() { return mngr_; }
+    // Modo del FramePacer: vsync, 'fps' frames por segundo (por defecto 100,
+    // uno por tick) o sin limite
+    void setPacing(FramePacer::Mode mode, int fps = 100);
+
+    // Bucle sin ventana: 'ticks' ticks de simulacion de TICK_MS ms de tiempo
+    // virtual, tan rapido como se pueda (sin esperas ni entrada). Las rondas
+    // empiezan solas, y al terminar escribe cuanto ha tardado. Con worlds > 1
+    // se simulan a la vez 'worlds' partidas independientes, cada una en su
+    // hilo, con semillas seed, seed+1, ...
+    void startHeadless(unsigned long ticks, int worlds, unsigned seed);
+
+    // Como startHeadless, pero con un BatchEnv de 'envs' partidas y
+    // acciones aleatorias: mide cuantos pasos por segundo da step()
+    void startBatchEnv(unsigned long ticks, int envs, unsigned seed);
+
+    // Los recursos del juego (y el archivo empaquetado, ver ResourceArchive)
+    static constexpr const char* RESOURCES = "resources/config/asteroid.resources.json";
+
+    static constexpr int TICK_MS = 10;  // duracion de un tick (como en start)
+    static constexpr int MAX_TICKS_PER_FRAME = 5;  // si un frame tarda mas, se ralentiza
+
+    inline World* getWorld() { return _world; }
+    inline ThreadPool* getThreadPool() { return _pool; }
 
     enum State { RUNNING, PAUSED, NEWGAME, NEWROUND, GAMEOVER };
     void setState(State s);
@@ -27,24 +65,45 @@ public:
     // Indica si el estado cambio durante este frame (para abortar el update)
     inline bool stateChanged() const { return _stateChanged; }
 
-    void checkCollisions();
+    // Si un frame tiene varios ticks, solo se pinta el ultimo: los estados
+    // solo graban el frame (ver clearFrame) cuando esto es true
+    inline bool renderTick() const { return _renderTick; }
 
 private:
     Game();
 
-    ecs::EntityManager* mngr_;
+    // Pantalla de carga: una barra con el progreso de los recursos, hasta
+    // que esten todos (ver SDLUtils::startLoading)
+    void showLoading();
+
+    // Hilo del juego: espera a que le den paso, hace un update() del estado
+    // actual y avisa de que ha terminado
+    void gameThread();
+    void runFrame(int ticks);  // da paso al hilo del juego, para 'ticks' ticks
+    void waitFrame();          // espera a que termine
+
+    World* _world;      // la partida (entidades, sistemas, reloj...)
+    ThreadPool* _pool;  // hilos para los bucles grandes (p.ej. vecinos de Flocking)
 
     GameState* _state;
-    GameState* _running_state;
+    RunningState* _running_state;
     GameState* _paused_state;
     GameState* _newgame_state;
     GameState* _newround_state;
     GameState* _gameover_state;
 
-    FighterUtils* _fu;
-    AsteroidsUtils* _au;
-
     bool _stateChanged;  // true si setState() fue llamado este frame
+    bool _renderTick;    // el tick actual es el ultimo del frame
+
+    std::thread             _thread;     // hilo del juego
+    std::mutex              _frameMutex;
+    std::condition_variable _frameCV;
+    bool                    _frameReq;   // hay un update() pedido
+    int                     _frameTicks; // cuantos
+    bool                    _frameDone;  // y ya se ha hecho
+    bool                    _quit;       // el hilo del juego debe terminar
+
+    FramePacer _pacer;  // cuando termina cada frame, y sus tiempos
 };
 
 inline Game& game() {
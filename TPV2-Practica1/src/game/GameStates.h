@@ -3,6 +3,7 @@
 #pragma once
 #include <string>
 #include <cmath>
+#include <initializer_list>
 #include "GameState.h"
 #include "FighterUtils.h"
 #include "AsteroidsUtils.h"
@@ -11,52 +12,124 @@
 #include "../sdlutils/Texture.h"
 #include "../sdlutils/macros.h"
 #include "Game.h"
+#include "World.h"
 
 // ---- Helpers ----
+//
+// Los estados no pintan: graban el frame en sdlutils().commands() y lo
+// publican al terminar (ver RenderQueue), y Game lo pinta en el hilo
+// principal mientras se graba el siguiente. Solo se graba en el ultimo
+// tick de cada frame (Game::renderTick), los demas solo actualizan.
 
+inline void clearFrame() {
+    sdlutils().commands().clear(build_sdlcolor(0x00000000));
+}
+
+inline void publishFrame() {
+    sdlutils().renderQueue().publish();
+}
+
+// Capas de la LayerCache: lo que no cambia en cada frame (el HUD, las
+// pantallas de los menus) se pinta una vez en una textura y luego se
+// dibuja esa textura, con una sola llamada
+enum CachedLayer : std::uint32_t {
+    CACHE_NEWGAME,
+    CACHE_NEWROUND,
+    CACHE_HUD,
+    CACHE_PAUSED,
+    CACHE_GAMEOVER
+};
+
+// Lo que pinte 'draw' va a la capa 'id', en la capa del HUD, y solo se
+// vuelve a pintar cuando cambia 'version' (que tiene que cambiar siempre
+// que cambie lo que se pinta)
+template<typename F>
+inline void drawCached(CachedLayer id, std::uint64_t version, F draw) {
+    auto& cmds = sdlutils().commands();
+    cmds.setLayer(World::LAYER_HUD);
+    cmds.beginCached(id, version);
+    draw();
+    cmds.endCached();
+}
+
+// Texto que no cambia: la textura se crea la primera vez y se guarda
 inline void drawCenteredText(const std::string& text, int y, SDL_Color color) {
-    Texture tex(sdlutils().renderer(), text,
-        sdlutils().fonts().at("NES16"), color);
-    float x = (sdlutils().width() - tex.width()) / 2.0f;
-    tex.render(x, (float)y - tex.height() / 2.0f);
+    sdlutils().commands().setLayer(World::LAYER_HUD);
+    sdlutils().commands().cachedText(sdlutils().fonts().at("NES16"), text,
+        sdlutils().width() / 2.0f, (float)y, color, RenderList::CENTER);
+}
+
+// Texto que cambia (numeros): letra a letra, del atlas de la fuente
+inline void drawCenteredValue(const std::string& text, int y, SDL_Color color) {
+    sdlutils().commands().setLayer(World::LAYER_HUD);
+    sdlutils().commands().text(sdlutils().fonts().at("NES16"), text,
+        sdlutils().width() / 2.0f, (float)y, color, RenderList::CENTER);
 }
 
 inline void drawHearts(int lives) {
     if (lives <= 0) return;
-    auto& heartTex = sdlutils().images().at("heart");
+    // Se busca una vez (ver ResourceCache), los estados que lo pintan lo fijan
+    static const Texture& heartTex = sdlutils().images().at("heart");
+    auto& cmds = sdlutils().commands();
+    cmds.setLayer(World::LAYER_HUD);
     float size = 28.0f;
     for (int i = 0; i < lives; i++) {
         SDL_FRect dest{ 8.0f + i * (size + 4.0f), 8.0f, size, size };
-        heartTex.render(dest);
+        cmds.draw(heartTex, dest);
     }
 }
 
+// Recursos que se usan mientras se esta en un estado. Los componentes se
+// guardan punteros a las texturas (y los clips de las animaciones), que no
+// se pueden descargar mientras se pintan: cada estado fija (pin) lo que usa
+// en enter() y lo suelta en leave(). Si se cargan al usarse (ver
+// "residency" en el fichero de recursos), fijarlos los carga antes del
+// primer frame que los pinta, o como mucho en ese frame
+inline void pinResources(std::initializer_list<const char*> images,
+    std::initializer_list<const char*> sounds, bool pin) {
+    for (auto* key : images)
+        pin ? sdlutils().images().pin(key) : sdlutils().images().unpin(key);
+    for (auto* key : sounds)
+        pin ? sdlutils().soundEffects().pin(key) : sdlutils().soundEffects().unpin(key);
+}
+
+// Lo que usa el mundo y el HUD durante una ronda
+inline void pinWorld(bool pin) {
+    pinResources({ "fighter", "asteroid", "asteroid_gold", "fire", "heart" },
+        { "gunshot", "explosion", "thrust" }, pin);
+}
+
 // ============================================================
 // NewGameState
 // ============================================================
 class NewGameState : public GameState {
 public:
-    NewGameState(Game* game, FighterUtils* fu, AsteroidsUtils* au)
-        : game_(game), fu_(fu), au_(au) {
+    NewGameState(Game* game, World* world)
+        : game_(game), world_(world),
+        fu_(world->getFighter()), au_(world->getAsteroids()) {
     }
     void enter()  override {}
     void leave()  override {}
     void update() override {
-        sdlutils().clearRenderer(build_sdlcolor(0x00000000));
-        int cy = sdlutils().height() / 2;
-        drawCenteredText("A S T E R O I D S", cy - 70, build_sdlcolor(0xffff00ff));
-        drawCenteredText("Flechas izq/der: girar", cy - 20, build_sdlcolor(0x888888ff));
-        drawCenteredText("W / flecha arriba: acelerar", cy + 5, build_sdlcolor(0x888888ff));
-        drawCenteredText("S: disparar    P: pausa", cy + 30, build_sdlcolor(0x888888ff));
-        drawCenteredText("press any key to start", cy + 75, build_sdlcolor(0xffffffff));
-        sdlutils().presentRenderer();
+        if (game_->renderTick()) {
+            clearFrame();
+            drawCached(CACHE_NEWGAME, 0, []() {
+                int cy = sdlutils().height() / 2;
+                drawCenteredText("A S T E R O I D S", cy - 70, build_sdlcolor(0xffff00ff));
+                drawCenteredText("Flechas izq/der: girar", cy - 20, build_sdlcolor(0x888888ff));
+                drawCenteredText("W / flecha arriba: acelerar", cy + 5, build_sdlcolor(0x888888ff));
+                drawCenteredText("S: disparar    P: pausa", cy + 30, build_sdlcolor(0x888888ff));
+                drawCenteredText("press any key to start", cy + 75, build_sdlcolor(0xffffffff));
+                });
+            publishFrame();
+        }
         if (ih().keyDownEvent()) {
             fu_->reset_lives();
             game_->setState(Game::NEWROUND);
         }
     }
 private:
-    Game* game_; FighterUtils* fu_; AsteroidsUtils* au_;
+    Game* game_; World* world_; FighterUtils* fu_; AsteroidsUtils* au_;
 };
 
 // ============================================================
@@ -64,26 +137,31 @@ private:
 // ============================================================
 class NewRoundState : public GameState {
 public:
-    NewRoundState(Game* game, FighterUtils* fu, AsteroidsUtils* au)
-        : game_(game), fu_(fu), au_(au) {
+    NewRoundState(Game* game, World* world)
+        : game_(game), world_(world),
+        fu_(world->getFighter()), au_(world->getAsteroids()) {
     }
-    void enter()  override {}
-    void leave()  override {}
+    // Se carga ya lo de la ronda, que empieza al pulsar ENTER
+    void enter()  override { pinWorld(true); }
+    void leave()  override { pinWorld(false); }
     void update() override {
-        sdlutils().clearRenderer(build_sdlcolor(0x00000000));
-        drawHearts(fu_->get_lives());
-        drawCenteredText("press ENTER to start the round",
-            sdlutils().height() / 2, build_sdlcolor(0xffffffff));
-        sdlutils().presentRenderer();
+        if (game_->renderTick()) {
+            clearFrame();
+            int lives = fu_->get_lives();
+            drawCached(CACHE_NEWROUND, (std::uint64_t)lives, [lives]() {
+                drawHearts(lives);
+                drawCenteredText("press ENTER to start the round",
+                    sdlutils().height() / 2, build_sdlcolor(0xffffffff));
+                });
+            publishFrame();
+        }
         if (ih().isKeyDown(SDL_SCANCODE_RETURN)) {
-            fu_->reset_fighter();
-            au_->remove_all_asteroids();
-            au_->create_asteroids(10);
+            world_->newRound();
             game_->setState(Game::RUNNING);
         }
     }
 private:
-    Game* game_; FighterUtils* fu_; AsteroidsUtils* au_;
+    Game* game_; World* world_; FighterUtils* fu_; AsteroidsUtils* au_;
 };
 
 // ============================================================
@@ -91,48 +169,49 @@ private:
 // ============================================================
 class RunningState : public GameState {
 public:
-    RunningState(Game* game, FighterUtils* fu, AsteroidsUtils* au)
-        : game_(game), fu_(fu), au_(au), _lastAsteroidTime(0) {
+    RunningState(Game* game, World* world)
+        : game_(game), world_(world),
+        fu_(world->getFighter()), au_(world->getAsteroids()) {
     }
 
-    void enter() override {
-        _lastAsteroidTime = sdlutils().virtualTimer().currTime();
-    }
-    void leave() override {}
+    void enter() override { pinWorld(true); }
+    void leave() override { pinWorld(false); }
 
     void update() override {
-        if (au_->count() == 0) {
-            game_->setState(Game::GAMEOVER);
-            return;
-        }
-        if (ih().isKeyDown(SDL_SCANCODE_P)) {
+        if (ih().isKeyDown(SDL_SCANCODE_P) && au_->count() != 0) {
             game_->setState(Game::PAUSED);
             return;
         }
+        if (!step()) return;
+        if (game_->renderTick()) render();
+    }
 
-        uint32_t now = sdlutils().virtualTimer().currTime();
-        if (now - _lastAsteroidTime >= 5000u) {
-            _lastAsteroidTime = now;
-            au_->create_asteroids(1);
+    // Un tick de simulacion del mundo, sin pintar nada. Devuelve false si
+    // ha cambiado el estado (fin de la partida, vida perdida)
+    bool step() {
+        switch (world_->step()) {
+        case World::NONE:
+            return true;
+        case World::FIGHTER_HIT:
+            game_->setState(fu_->get_lives() <= 0 ? Game::GAMEOVER : Game::NEWROUND);
+            return false;
+        case World::NO_ASTEROIDS:
+        default:
+            game_->setState(Game::GAMEOVER);
+            return false;
         }
+    }
 
-        game_->getMngr()->update();
-
-        game_->checkCollisions();
-        // Si checkCollisions cambio el estado (vida perdida o muerte), salir
-        if (game_->stateChanged()) return;
-
-        game_->getMngr()->refresh();
-
-        sdlutils().clearRenderer(build_sdlcolor(0x00000000));
-        game_->getMngr()->render();
-        drawHearts(fu_->get_lives());
-        sdlutils().presentRenderer();
+    void render() {
+        clearFrame();
+        world_->render();
+        int lives = fu_->get_lives();
+        drawCached(CACHE_HUD, (std::uint64_t)lives, [lives]() { drawHearts(lives); });
+        publishFrame();
     }
 
 private:
-    Game* game_; FighterUtils* fu_; AsteroidsUtils* au_;
-    uint32_t _lastAsteroidTime;
+    Game* game_; World* world_; FighterUtils* fu_; AsteroidsUtils* au_;
 };
 
 // ============================================================
@@ -140,30 +219,43 @@ private:
 // ============================================================
 class PausedState : public GameState {
 public:
-    PausedState(Game* game, FighterUtils* fu, AsteroidsUtils* au)
-        : game_(game), fu_(fu), au_(au) {
+    PausedState(Game* game, World* world)
+        : game_(game), world_(world),
+        fu_(world->getFighter()), au_(world->getAsteroids()) {
     }
-    void enter() override { sdlutils().virtualTimer().pause(); }
-    void leave() override { sdlutils().virtualTimer().resume(); }
+    void enter() override { pinWorld(true); world_->clock().pause(); }
+    void leave() override { pinWorld(false); world_->clock().resume(); }
     void update() override {
-        sdlutils().clearRenderer(build_sdlcolor(0x00000000));
-        int cy = sdlutils().height() / 2;
-        drawCenteredText("- PAUSED -",
-            cy - 80, build_sdlcolor(0xffff00ff));
-        drawCenteredText("Lives: " + std::to_string(fu_->get_lives()),
-            cy - 30, build_sdlcolor(0xffffffff));
-        drawCenteredText("Asteroids: " + std::to_string(au_->count()),
-            cy, build_sdlcolor(0xffffffff));
-        drawCenteredText("Min dist: " + std::to_string((int)std::round(au_->minDistanceToFighter())),
-            cy + 30, build_sdlcolor(0xffffffff));
-        drawCenteredText("press any key to resume",
-            cy + 80, build_sdlcolor(0x00ff00ff));
-        drawHearts(fu_->get_lives());
-        sdlutils().presentRenderer();
+        if (game_->renderTick()) render();
         if (ih().keyDownEvent()) game_->setState(Game::RUNNING);
     }
+
 private:
-    Game* game_; FighterUtils* fu_; AsteroidsUtils* au_;
+    void render() {
+        clearFrame();
+        int lives = fu_->get_lives();
+        int count = (int)au_->count();
+        int dist = (int)std::round(au_->minDistanceToFighter());
+        std::uint64_t version = ((std::uint64_t)(std::uint8_t)lives << 56)
+            | ((std::uint64_t)(std::uint16_t)count << 32) | (std::uint32_t)dist;
+        drawCached(CACHE_PAUSED, version, [lives, count, dist]() {
+            int cy = sdlutils().height() / 2;
+            drawCenteredText("- PAUSED -",
+                cy - 80, build_sdlcolor(0xffff00ff));
+            drawCenteredValue("Lives: " + std::to_string(lives),
+                cy - 30, build_sdlcolor(0xffffffff));
+            drawCenteredValue("Asteroids: " + std::to_string(count),
+                cy, build_sdlcolor(0xffffffff));
+            drawCenteredValue("Min dist: " + std::to_string(dist),
+                cy + 30, build_sdlcolor(0xffffffff));
+            drawCenteredText("press any key to resume",
+                cy + 80, build_sdlcolor(0x00ff00ff));
+            drawHearts(lives);
+            });
+        publishFrame();
+    }
+
+    Game* game_; World* world_; FighterUtils* fu_; AsteroidsUtils* au_;
 };
 
 // ============================================================
@@ -171,50 +263,61 @@ private:
 // ============================================================
 class GameOverState : public GameState {
 public:
-    GameOverState(Game* game, FighterUtils* fu, AsteroidsUtils* au)
-        : game_(game), fu_(fu), au_(au), _won(false), _enterTime(0), _lives(0) {
+    GameOverState(Game* game, World* world)
+        : game_(game), world_(world),
+        fu_(world->getFighter()), au_(world->getAsteroids()), _won(false), _enterTime(0), _lives(0) {
     }
 
     void enter() override {
         _won = (au_->count() == 0);
-        _enterTime = sdlutils().virtualTimer().currTime();
+        _enterTime = world_->clock().currTime();
         // Guardar vidas AHORA antes de que el fighter pueda ser destruido
         _lives = fu_->get_lives();
+        pinResources({ "heart" }, { "explosion" }, true);
         sdlutils().soundEffects().at("explosion").play();
     }
-    void leave() override {}
+    void leave() override { pinResources({ "heart" }, { "explosion" }, false); }
 
     void update() override {
-        sdlutils().clearRenderer(build_sdlcolor(0x00000000));
-        int cy = sdlutils().height() / 2;
-
-        if (_won) {
-            drawCenteredText("** GAME OVER **",
-                cy - 60, build_sdlcolor(0xffff00ff));
-            drawCenteredText("Champion! All asteroids destroyed!",
-                cy - 20, build_sdlcolor(0x00ff00ff));
-        }
-        else {
-            drawCenteredText("** GAME OVER **",
-                cy - 60, build_sdlcolor(0xff0000ff));
-            drawCenteredText("You ran out of lives... Loser!",
-                cy - 20, build_sdlcolor(0xff4444ff));
+        uint32_t elapsed = world_->clock().currTime() - _enterTime;
+        bool showEnter = elapsed > 1500u;
+
+        if (showEnter && ih().isKeyDown(SDL_SCANCODE_RETURN)) {
+            game_->setState(Game::NEWGAME);
+            return;
         }
+        if (!game_->renderTick()) return;
 
-        drawHearts(_lives);   // usar las vidas guardadas en enter(), no las del fighter
+        clearFrame();
+        std::uint64_t version = ((std::uint64_t)(std::uint8_t)_lives << 2)
+            | (_won ? 2u : 0u) | (showEnter ? 1u : 0u);
+        drawCached(CACHE_GAMEOVER, version, [this, showEnter]() {
+            int cy = sdlutils().height() / 2;
 
-        uint32_t elapsed = sdlutils().virtualTimer().currTime() - _enterTime;
-        if (elapsed > 1500u) {
-            drawCenteredText("Press ENTER to play again",
-                cy + 40, build_sdlcolor(0xffffffff));
-            if (ih().isKeyDown(SDL_SCANCODE_RETURN))
-                game_->setState(Game::NEWGAME);
-        }
-        sdlutils().presentRenderer();
+            if (_won) {
+                drawCenteredText("** GAME OVER **",
+                    cy - 60, build_sdlcolor(0xffff00ff));
+                drawCenteredText("Champion! All asteroids destroyed!",
+                    cy - 20, build_sdlcolor(0x00ff00ff));
+            }
+            else {
+                drawCenteredText("** GAME OVER **",
+                    cy - 60, build_sdlcolor(0xff0000ff));
+                drawCenteredText("You ran out of lives... Loser!",
+                    cy - 20, build_sdlcolor(0xff4444ff));
+            }
+
+            drawHearts(_lives);   // usar las vidas guardadas en enter(), no las del fighter
+
+            if (showEnter)
+                drawCenteredText("Press ENTER to play again",
+                    cy + 40, build_sdlcolor(0xffffffff));
+            });
+        publishFrame();
     }
 
 private:
-    Game* game_; FighterUtils* fu_; AsteroidsUtils* au_;
+    Game* game_; World* world_; FighterUtils* fu_; AsteroidsUtils* au_;
     bool     _won;
     uint32_t _enterTime;
     int      _lives;   // guardado en enter() para evitar acceso a fighter muerto
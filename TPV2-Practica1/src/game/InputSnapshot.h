@@ -0,0 +1,37 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+#include <bitset>
+#include <SDL.h>
+#include "../sdlutils/InputHandler.h"
+
+// Teclas pulsadas en un tick, copiadas del InputHandler (que es global) o
+// puestas a mano (simulaciones sin ventana, varias partidas a la vez...).
+// Los componentes leen la entrada de aqui, a traves de su World.
+
+class InputSnapshot {
+public:
+    InputSnapshot() : _keys() {}
+
+    inline bool isKeyDown(SDL_Scancode key) const {
+        return _keys[key];
+    }
+
+    inline void setKeyDown(SDL_Scancode key, bool down) {
+        _keys[key] = down;
+    }
+
+    // Todas sin pulsar
+    inline void clear() {
+        _keys.reset();
+    }
+
+    // Copia el estado del teclado, despues de ih().refresh()
+    inline void capture(InputHandler& ihdlr) {
+        for (int k = 0; k < SDL_SCANCODE_COUNT; k++)
+            _keys[k] = ihdlr.isKeyDown((SDL_Scancode)k);
+    }
+
+private:
+    std::bitset<SDL_SCANCODE_COUNT> _keys;
+};
@@ -0,0 +1,202 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "ParticleSystem.h"
+
+#include <algorithm>
+#include <cassert>
+#include "../sdlutils/SDLUtils.h"
+#include "../sdlutils/Texture.h"
+#include "../utils/FastRotation.h"
+#include "../utils/simd.h"
+
+// Las velocidades se multiplican por DRAG en cada tick (frenan poco a poco)
+static const float DRAG = 0.96f;
+
+ParticleSystem::ParticleSystem(unsigned seed, std::size_t capacityPerTexture) :
+    _rand(seed),
+    _capacity(1),
+    _pools()
+{
+    // potencia de 2, para que el buffer circular avance con una mascara
+    while (_capacity < capacityPerTexture)
+        _capacity <<= 1;
+}
+
+ParticleSystem::~ParticleSystem() {
+    for (auto* p : _pools)
+        delete p;
+}
+
+ParticleSystem::Pool& ParticleSystem::pool(const std::string& key) {
+    for (auto* p : _pools)
+        if (p->key == key)
+            return *p;
+
+    Pool* p = new Pool();
+    p->key = key;
+    p->tex = &sdlutils().images().at(key);
+    p->head = 0;
+    p->tail = 0;
+    p->count = 0;
+    p->x.resize(_capacity);
+    p->y.resize(_capacity);
+    p->vx.resize(_capacity);
+    p->vy.resize(_capacity);
+    p->life.resize(_capacity);
+    p->invLife.resize(_capacity);
+    p->size.resize(_capacity);
+    p->color.resize(_capacity);
+    _pools.push_back(p);
+    return *p;
+}
+
+// ---- Emitir ----
+
+void ParticleSystem::emit(const std::string& key, Vec2 pos, Vec2 vel, float life,
+    float size, SDL_FColor color) {
+    assert(life > 0.0f);
+    Pool& p = pool(key);
+
+    std::size_t i = p.head;
+    p.head = (p.head + 1) & (_capacity - 1);
+    if (p.count < _capacity)
+        p.count++;
+    else
+        p.tail = p.head;  // lleno: se reemplaza la mas antigua
+
+    // size/2 para que pos sea el centro
+    p.x[i] = pos.x - size * 0.5f;
+    p.y[i] = pos.y - size * 0.5f;
+    p.vx[i] = vel.x;
+    p.vy[i] = vel.y;
+    p.life[i] = life;
+    p.invLife[i] = 1.0f / life;
+    p.size[i] = size;
+    p.color[i] = color;
+}
+
+void ParticleSystem::explosion(Vec2 center, float radius) {
+    auto& rng = _rand;
+    int n = std::clamp((int)(radius * 2.0f), 8, 200);
+    for (int k = 0; k < n; k++) {
+        SinCos sc = SinCos::fromDegrees((float)rng.nextInt(0, 360));
+        float speed = rng.nextInt(5, 31) / 10.0f;
+        Vec2 dir(sc.cos, sc.sin);
+        // de amarillo (g=1) a rojo (g=0.3)
+        float g = rng.nextInt(30, 101) / 100.0f;
+        emit("fire", center + dir * (radius * 0.3f), dir * speed,
+            (float)rng.nextInt(30, 61), (float)rng.nextInt(2, 6),
+            SDL_FColor{ 1.0f, g, 0.2f, 1.0f });
+    }
+}
+
+void ParticleSystem::thrust(Vec2 pos, Vec2 dir) {
+    auto& rng = _rand;
+    for (int k = 0; k < 2; k++) {
+        Vec2 jitter(rng.nextInt(-10, 11) / 20.0f, rng.nextInt(-10, 11) / 20.0f);
+        emit("fire", pos, dir * 2.0f + jitter,
+            (float)rng.nextInt(15, 26), 3.0f,
+            SDL_FColor{ 0.7f, 0.7f, 0.8f, 1.0f });
+    }
+}
+
+void ParticleSystem::clear() {
+    for (auto* p : _pools) {
+        p->head = 0;
+        p->tail = 0;
+        p->count = 0;
+    }
+}
+
+// La ventana [tail, tail+count) puede dar la vuelta al final del buffer, en
+// ese caso son dos tramos: f(begin, end) se llama para cada uno
+template<typename F>
+static void forEachSegment(std::size_t tail, std::size_t count,
+    std::size_t capacity, F f) {
+    std::size_t end = tail + count;
+    if (end <= capacity) {
+        f(tail, end);
+    }
+    else {
+        f(tail, capacity);
+        f((std::size_t)0, end - capacity);
+    }
+}
+
+std::size_t ParticleSystem::liveCount() const {
+    std::size_t n = 0;
+    for (auto* p : _pools)
+        forEachSegment(p->tail, p->count, _capacity,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++)
+                    if (p->life[i] > 0.0f) n++;
+            });
+    return n;
+}
+
+// ---- Update ----
+//
+// Se actualizan tambien las muertas de dentro de la ventana (es mas barato
+// que comprobarlo): su vida sigue bajando y no se pintan. Despues se
+// descartan las muertas del principio de la ventana.
+
+static void updateRange(float* x, float* y, float* vx, float* vy, float* life,
+    std::size_t i, std::size_t n) {
+#ifdef _USE_SSE2
+    const __m128 drag = _mm_set1_ps(DRAG);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 vx4 = _mm_loadu_ps(vx + i);
+        __m128 vy4 = _mm_loadu_ps(vy + i);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), vx4));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), vy4));
+        _mm_storeu_ps(vx + i, _mm_mul_ps(vx4, drag));
+        _mm_storeu_ps(vy + i, _mm_mul_ps(vy4, drag));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), one));
+    }
+#endif
+
+    for (; i < n; i++) {
+        x[i] += vx[i];
+        y[i] += vy[i];
+        vx[i] *= DRAG;
+        vy[i] *= DRAG;
+        life[i] -= 1.0f;
+    }
+}
+
+void ParticleSystem::update() {
+    for (auto* p : _pools) {
+        forEachSegment(p->tail, p->count, _capacity,
+            [p](std::size_t begin, std::size_t end) {
+                updateRange(p->x.data(), p->y.data(), p->vx.data(),
+                    p->vy.data(), p->life.data(), begin, end);
+            });
+
+        while (p->count > 0 && p->life[p->tail] <= 0.0f) {
+            p->tail = (p->tail + 1) & (_capacity - 1);
+            p->count--;
+        }
+    }
+}
+
+// ---- Render ----
+
+void ParticleSystem::render() {
+    auto& cmds = sdlutils().commands();
+    for (auto* p : _pools) {
+        SDL_FRect src{ 0.0f, 0.0f, (float)p->tex->width(), (float)p->tex->height() };
+
+        forEachSegment(p->tail, p->count, _capacity,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    if (p->life[i] <= 0.0f) continue;
+
+                    SDL_FRect dest{ p->x[i], p->y[i], p->size[i], p->size[i] };
+                    SDL_FColor c = p->color[i];
+                    c.a = p->life[i] * p->invLife[i];  // se desvanece
+                    cmds.draw(*p->tex, src, dest, 0.0f, c);
+                }
+            });
+    }
+}
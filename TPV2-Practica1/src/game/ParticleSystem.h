@@ -0,0 +1,79 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include "../sdlutils/RandomNumberGenerator.h"
+#include "../utils/Vec2.h"
+
+class Texture;
+
+// Particulas de las explosiones y del motor del caza.
+//
+// Hay un pool por textura, y cada pool es un buffer circular en SoA (un
+// array por campo) con capacidad potencia de 2: emitir escribe en la
+// siguiente posicion y, si el buffer esta lleno, reemplaza a la particula
+// mas antigua, que es la que menos vida le queda porque todas viven poco.
+// Asi emitir es O(1) y no hay que eliminar nada: una particula sin vida
+// simplemente no se pinta hasta que la reemplazan.
+//
+// update() mueve todas las particulas de una vez (SSE de 4 en 4), y
+// render() graba un sprite por particula viva, que se va haciendo
+// transparente a medida que pierde vida. Al pintar la lista de comandos
+// el SpriteBatch junta todas las de una textura en una sola llamada a
+// SDL_RenderGeometry.
+//
+// Los numeros aleatorios salen de un generador propio, no del del World:
+// las particulas solo se ven, y un mundo que no se pinta no las tiene (ver
+// World::World), pero tiene que jugar la misma partida con la misma
+// semilla.
+
+class ParticleSystem {
+public:
+    // La vida de las particulas se mide en ticks (llamadas a update)
+    ParticleSystem(unsigned seed, std::size_t capacityPerTexture = 65536);
+    virtual ~ParticleSystem();
+
+    // Emite una particula con la textura 'key' de sdlutils().images()
+    void emit(const std::string& key, Vec2 pos, Vec2 vel, float life,
+        float size, SDL_FColor color);
+
+    // Explosion centrada en 'center', con mas particulas cuanto mas grande
+    void explosion(Vec2 center, float radius);
+
+    // Humo del motor, en 'pos' y saliendo en la direccion 'dir' (unitaria)
+    void thrust(Vec2 pos, Vec2 dir);
+
+    void update();
+    void render();
+    void clear();
+
+    // Particulas con vida, de todas las texturas (recorre todas)
+    std::size_t liveCount() const;
+
+private:
+    struct Pool {
+        std::string    key;
+        const Texture* tex;
+        std::size_t    head;   // siguiente posicion a escribir
+        std::size_t    tail;   // la mas antigua que puede estar viva
+        std::size_t    count;  // posiciones en [tail, head) (<= capacidad)
+
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> vx;
+        std::vector<float> vy;
+        std::vector<float> life;     // ticks que le quedan, <= 0 si esta muerta
+        std::vector<float> invLife;  // 1 / vida inicial, para el alpha
+        std::vector<float> size;
+        std::vector<SDL_FColor> color;
+    };
+
+    Pool& pool(const std::string& key);
+
+    RandomNumberGenerator _rand;
+    std::size_t _capacity;  // por textura, potencia de 2
+    std::vector<Pool*> _pools;
+};
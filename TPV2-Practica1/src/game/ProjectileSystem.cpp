@@ -0,0 +1,221 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "ProjectileSystem.h"
+
+#include <cassert>
+#include <memory>
+#include "../json/JSON.h"
+#include "../sdlutils/SDLUtils.h"
+#include "../sdlutils/Texture.h"
+#include "../utils/Vec2Batch.h"
+#include "../utils/simd.h"
+#include "World.h"
+
+// Valores por defecto si no estan en el fichero de configuracion
+static const std::size_t DEFAULT_CAPACITY = 20000;
+static const uint32_t DEFAULT_COOLDOWN = 250;
+
+ProjectileSystem::ProjectileSystem(World& world) :
+    _world(world),
+    _kinds(),
+    _owners(),
+    _capacity(0),
+    _n(0),
+    _x(),
+    _y(),
+    _vx(),
+    _vy(),
+    _w(),
+    _h(),
+    _rot(),
+    _owner(),
+    _out(),
+    _tex(nullptr)
+{
+    setCapacity(DEFAULT_CAPACITY);
+}
+
+ProjectileSystem::~ProjectileSystem() {
+}
+
+void ProjectileSystem::setCapacity(std::size_t capacity) {
+    // Los arrays se reservan enteros una sola vez, disparar nunca reserva
+    // memoria
+    assert(_n == 0);
+    _capacity = capacity;
+    _x.resize(capacity);
+    _y.resize(capacity);
+    _vx.resize(capacity);
+    _vy.resize(capacity);
+    _w.resize(capacity);
+    _h.resize(capacity);
+    _rot.resize(capacity);
+    _owner.resize(capacity);
+    _out.reserve(capacity);
+}
+
+void ProjectileSystem::loadConfig(const std::string& filename) {
+    std::unique_ptr<JSONValue> jValueRoot(JSON::ParseFromFile(filename));
+    if (jValueRoot == nullptr || !jValueRoot->IsObject()) {
+        throw "Something went wrong while load/parsing '" + filename + "'";
+    }
+
+    JSONObject root = jValueRoot->AsObject();
+    JSONValue* jValue = nullptr;
+
+    jValue = root["projectile_capacity"];
+    if (jValue != nullptr && jValue->IsNumber())
+        setCapacity(static_cast<std::size_t>(jValue->AsNumber()));
+
+    jValue = root["projectile_owners"];
+    if (jValue != nullptr && jValue->IsObject()) {
+        for (auto& kv : jValue->AsObject()) {
+            if (!kv.second->IsObject()) continue;
+            JSONObject o = kv.second->AsObject();
+            OwnerKind k{ kv.first, _capacity, DEFAULT_COOLDOWN };
+            if (o["max"] != nullptr && o["max"]->IsNumber())
+                k.max = static_cast<std::size_t>(o["max"]->AsNumber());
+            if (o["cooldown_ms"] != nullptr && o["cooldown_ms"]->IsNumber())
+                k.cooldown = static_cast<uint32_t>(o["cooldown_ms"]->AsNumber());
+            _kinds.push_back(k);
+        }
+    }
+}
+
+int ProjectileSystem::addOwner(const std::string& kind) {
+    Owner o{ _capacity, 0, DEFAULT_COOLDOWN, true };
+    for (auto& k : _kinds)
+        if (k.kind == kind) {
+            o.max = k.max;
+            o.cooldown = k.cooldown;
+        }
+    // Se reutiliza el hueco de un duenio eliminado, si lo hay
+    for (std::size_t i = 0; i < _owners.size(); i++)
+        if (!_owners[i].used) {
+            _owners[i] = o;
+            return (int)i;
+        }
+    _owners.push_back(o);
+    return (int)_owners.size() - 1;
+}
+
+void ProjectileSystem::removeOwner(int owner) {
+    clear(owner);
+    _owners[owner].used = false;
+}
+
+// ---- Disparar / eliminar ----
+
+bool ProjectileSystem::spawn(int owner, Vec2 pos, Vec2 vel, float w, float h, float rot) {
+    Owner& o = _owners[owner];
+    if (_n == _capacity || o.live >= o.max)
+        return false;
+
+    std::size_t i = _n++;
+    _x[i] = pos.x;
+    _y[i] = pos.y;
+    _vx[i] = vel.x;
+    _vy[i] = vel.y;
+    _w[i] = w;
+    _h[i] = h;
+    _rot[i] = rot;
+    _owner[i] = (uint16_t)owner;
+    o.live++;
+    return true;
+}
+
+void ProjectileSystem::despawn(std::size_t i) {
+    assert(i < _n);
+    _owners[_owner[i]].live--;
+
+    // la ultima pasa al hueco
+    std::size_t last = --_n;
+    _x[i] = _x[last];
+    _y[i] = _y[last];
+    _vx[i] = _vx[last];
+    _vy[i] = _vy[last];
+    _w[i] = _w[last];
+    _h[i] = _h[last];
+    _rot[i] = _rot[last];
+    _owner[i] = _owner[last];
+}
+
+void ProjectileSystem::clear(int owner) {
+    std::size_t i = 0;
+    while (i < _n) {
+        if (_owner[i] == owner)
+            despawn(i);  // i tiene ahora otra bala, no avanzar
+        else
+            i++;
+    }
+}
+
+void ProjectileSystem::clear() {
+    _n = 0;
+    for (auto& o : _owners)
+        o.live = 0;
+}
+
+// ---- Update ----
+
+void ProjectileSystem::update() {
+    if (_n == 0) return;
+
+    // pos += vel, para todas a la vez
+    Vec2Span pos{ _x.data(), _y.data(), _n };
+    Vec2Span vel{ _vx.data(), _vy.data(), _n };
+    vec2batch::add(pos, pos, vel);
+
+    // Las que han salido de la pantalla: x < -w || x > sw || y < -h || y > sh
+    const float sw = _world.width();
+    const float sh = _world.height();
+
+    _out.clear();
+    std::size_t i = 0;
+
+#ifdef _USE_SSE2
+    const __m128 vsw = _mm_set1_ps(sw);
+    const __m128 vsh = _mm_set1_ps(sh);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= _n; i += 4) {
+        __m128 x = _mm_loadu_ps(&_x[i]);
+        __m128 y = _mm_loadu_ps(&_y[i]);
+        __m128 nw = _mm_sub_ps(zero, _mm_loadu_ps(&_w[i]));
+        __m128 nh = _mm_sub_ps(zero, _mm_loadu_ps(&_h[i]));
+        __m128 out = _mm_or_ps(
+            _mm_or_ps(_mm_cmplt_ps(x, nw), _mm_cmpgt_ps(x, vsw)),
+            _mm_or_ps(_mm_cmplt_ps(y, nh), _mm_cmpgt_ps(y, vsh)));
+        int mask = _mm_movemask_ps(out);
+        // casi siempre 0: ninguna de las 4 ha salido
+        for (int k = 0; mask != 0; k++, mask >>= 1)
+            if (mask & 1)
+                _out.push_back(i + k);
+    }
+#endif
+
+    for (; i < _n; i++)
+        if (_x[i] < -_w[i] || _x[i] > sw || _y[i] < -_h[i] || _y[i] > sh)
+            _out.push_back(i);
+
+    // Se eliminan de la ultima a la primera: al eliminar i, la ultima bala
+    // (que pasa a i) nunca es una de las que quedan por eliminar
+    for (auto it = _out.rbegin(); it != _out.rend(); ++it)
+        despawn(*it);
+}
+
+void ProjectileSystem::render() {
+    if (_n == 0) return;
+
+    // Al SpriteBatch (al pintar la lista de comandos): todas las balas en
+    // una sola llamada, y girarlas ya no cuesta nada (el sprite va en la
+    // direccion de la bala)
+    // La textura se busca la primera vez (ver ResourceCache)
+    if (_tex == nullptr)
+        _tex = &sdlutils().images().at("fire");
+    const auto& tex = *_tex;
+    auto& cmds = sdlutils().commands();
+    for (std::size_t i = 0; i < _n; i++) {
+        SDL_FRect dest{ _x[i], _y[i], _w[i], _h[i] };
+        cmds.draw(tex, dest, _rot[i]);
+    }
+}
@@ -0,0 +1,106 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../utils/Vec2.h"
+
+class Texture;
+class World;
+
+// Todas las balas del juego, de todas las armas, en un unico pool.
+//
+// Las balas vivas estan al principio de los arrays (SoA: un array por
+// campo), sin huecos: disparar escribe en la posicion size() y eliminar
+// mueve la ultima al hueco, ambas O(1). Asi update() y render() solo
+// recorren balas vivas, y el movimiento y la comprobacion de si han salido
+// de la pantalla se hacen con SSE de 4 en 4.
+//
+// Cada arma se registra como "duenio" (addOwner) con un tipo, y el fichero
+// de configuracion (asteroid.cfg.json) dice cuantas balas vivas puede tener
+// cada tipo y cada cuanto puede disparar:
+//
+//   "projectile_capacity": 20000,
+//   "projectile_owners": {
+//       "fighter": { "max": 20, "cooldown_ms": 250 }
+//   }
+//
+// Un tipo que no aparezca en el fichero puede usar todo el pool.
+//
+// Ojo: despawn(i) mueve la ultima bala a i, asi que si se eliminan balas
+// mientras se recorren, no hay que avanzar i despues de eliminar.
+
+class ProjectileSystem {
+public:
+    ProjectileSystem(World& world);
+    virtual ~ProjectileSystem();
+
+    // Lee capacidad y limites de asteroid.cfg.json (lanza una excepcion si
+    // el fichero no es un objeto JSON)
+    void loadConfig(const std::string& filename);
+
+    int addOwner(const std::string& kind);
+    // Elimina sus balas y deja su hueco libre para el siguiente addOwner
+    void removeOwner(int owner);
+    uint32_t cooldown(int owner) const { return _owners[owner].cooldown; }
+    std::size_t liveCount(int owner) const { return _owners[owner].live; }
+
+    // Devuelve false si el pool o el limite del duenio estan llenos
+    bool spawn(int owner, Vec2 pos, Vec2 vel, float w, float h, float rot);
+    void despawn(std::size_t i);
+    void clear(int owner);
+    void clear();
+
+    // Mueve todas las balas y elimina las que han salido de la pantalla
+    void update();
+    void render();
+
+    // ---- Acceso a las balas vivas, i en [0,size()) ----
+    std::size_t size() const { return _n; }
+    std::size_t capacity() const { return _capacity; }
+    Vec2  pos(std::size_t i) const { return Vec2(_x[i], _y[i]); }
+    Vec2  vel(std::size_t i) const { return Vec2(_vx[i], _vy[i]); }
+    float width(std::size_t i) const { return _w[i]; }
+    float height(std::size_t i) const { return _h[i]; }
+    float rot(std::size_t i) const { return _rot[i]; }
+    int   owner(std::size_t i) const { return _owner[i]; }
+
+private:
+    struct OwnerKind {
+        std::string kind;
+        std::size_t max;
+        uint32_t    cooldown;
+    };
+
+    struct Owner {
+        std::size_t max;
+        std::size_t live;
+        uint32_t    cooldown;
+        bool        used;  // false si se ha eliminado (removeOwner)
+    };
+
+    void setCapacity(std::size_t capacity);
+
+    World& _world;
+
+    std::vector<OwnerKind> _kinds;  // limites leidos del fichero
+    std::vector<Owner>     _owners;
+
+    std::size_t _capacity;
+    std::size_t _n;  // balas vivas
+
+    std::vector<float>    _x;   // top-left
+    std::vector<float>    _y;
+    std::vector<float>    _vx;
+    std::vector<float>    _vy;
+    std::vector<float>    _w;
+    std::vector<float>    _h;
+    std::vector<float>    _rot; // grados
+    std::vector<uint16_t> _owner;
+
+    std::vector<std::size_t> _out;  // indices de las que han salido (update)
+
+    const Texture* _tex;  // la de las balas
+};
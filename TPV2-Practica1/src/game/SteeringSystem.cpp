@@ -0,0 +1,271 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "SteeringSystem.h"
+
+#include <cassert>
+#include "../components/Transform.h"
+#include "../components/Follow.h"
+#include "../components/TowardDestination.h"
+#include "../components/Flocking.h"
+#include "../ecs/Entity.h"
+#include "../ecs/EntityManager.h"
+#include "../sdlutils/SDLUtils.h"
+#include "../utils/FastRotation.h"
+#include "../utils/ThreadPool.h"
+#include "World.h"
+#include "ecs_defs.h"
+
+SteeringSystem::SteeringSystem(World& world) :
+    _world(world),
+    _mngr(world.getMngr()),
+    _pool(world.getThreadPool()),
+    _flow(world.width(), world.height(), 40.0f),
+    _followers(),
+    _followerCmps(),
+    _followerWraps(),
+    _seekers(),
+    _seekerCmps(),
+    _dests(),
+    _speeds(),
+    _flockers(),
+    _flockerCmps(),
+    _separation(),
+    _alignment(),
+    _cohesion(),
+    _grid(world.width(), world.height(), FLOCK_RADIUS),
+    _pos(),
+    _vel(),
+    _want(),
+    _dist2()
+{
+}
+
+SteeringSystem::~SteeringSystem() {
+}
+
+// ---- Registro ----
+//
+// Se borra moviendo el ultimo elemento al hueco, asi que hay que actualizar
+// el indice que guarda el componente movido.
+
+template<typename T>
+static void swapPop(std::vector<T>& v, std::size_t i) {
+    v[i] = v.back();
+    v.pop_back();
+}
+
+void SteeringSystem::addFollower(Follow* f, Transform* tr, bool wraps) {
+    assert(f->_steeringIdx < 0);
+    f->_steeringIdx = (int)_followers.size();
+    _followers.push_back(tr);
+    _followerCmps.push_back(f);
+    _followerWraps.push_back(wraps ? 1 : 0);
+}
+
+void SteeringSystem::removeFollower(Follow* f) {
+    int i = f->_steeringIdx;
+    assert(i >= 0 && _followerCmps[i] == f);
+    swapPop(_followers, i);
+    swapPop(_followerCmps, i);
+    swapPop(_followerWraps, i);
+    if (i < (int)_followers.size())
+        _followerCmps[i]->_steeringIdx = i;
+    f->_steeringIdx = -1;
+}
+
+void SteeringSystem::addSeeker(TowardDestination* t, Transform* tr, float speed) {
+    assert(t->_steeringIdx < 0);
+    t->_steeringIdx = (int)_seekers.size();
+    _seekers.push_back(tr);
+    _seekerCmps.push_back(t);
+    _dests.push_back(pickDestination());
+    _speeds.push_back(speed);
+}
+
+void SteeringSystem::removeSeeker(TowardDestination* t) {
+    int i = t->_steeringIdx;
+    assert(i >= 0 && _seekerCmps[i] == t);
+    int last = (int)_seekers.size() - 1;
+    Vec2Span dests = _dests.span();
+    dests.set(i, dests[last]);
+    _dests.resize(last);
+    swapPop(_seekers, i);
+    swapPop(_seekerCmps, i);
+    swapPop(_speeds, i);
+    if (i < last)
+        _seekerCmps[i]->_steeringIdx = i;
+    t->_steeringIdx = -1;
+}
+
+void SteeringSystem::addFlocker(Flocking* f, Transform* tr, float separation,
+    float alignment, float cohesion) {
+    assert(f->_steeringIdx < 0);
+    f->_steeringIdx = (int)_flockers.size();
+    _flockers.push_back(tr);
+    _flockerCmps.push_back(f);
+    _separation.push_back(separation);
+    _alignment.push_back(alignment);
+    _cohesion.push_back(cohesion);
+}
+
+void SteeringSystem::removeFlocker(Flocking* f) {
+    int i = f->_steeringIdx;
+    assert(i >= 0 && _flockerCmps[i] == f);
+    swapPop(_flockers, i);
+    swapPop(_flockerCmps, i);
+    swapPop(_separation, i);
+    swapPop(_alignment, i);
+    swapPop(_cohesion, i);
+    if (i < (int)_flockers.size())
+        _flockerCmps[i]->_steeringIdx = i;
+    f->_steeringIdx = -1;
+}
+
+// ---- Update ----
+
+void SteeringSystem::update() {
+    updateFollowers();
+    updateSeekers();
+    updateFlockers();
+}
+
+void SteeringSystem::updateFollowers() {
+    std::size_t n = _followers.size();
+    if (n == 0) return;
+
+    // Posicion del caza, una sola vez por tick
+    auto* fighter = _mngr->getHandler(ecs::hdlr::FIGHTER_HDLR);
+    if (fighter == nullptr || !fighter->isAlive()) return;
+    auto* fighterTr = fighter->getComponent<Transform>();
+    if (fighterTr == nullptr) return;
+    _flow.setTarget(toVec2(fighterTr->getPos()));
+
+    _pos.resize(n);
+    _vel.resize(n);
+    _want.resize(n);
+    Vec2Span pos = _pos.span();
+    Vec2Span vel = _vel.span();
+    Vec2Span want = _want.span();
+
+    for (std::size_t i = 0; i < n; i++) {
+        pos.set(i, toVec2(_followers[i]->getPos()));
+        vel.set(i, toVec2(_followers[i]->getVel()));
+    }
+
+    // v = v.rotate(v.angle(w) > 0 ? 1.0f : -1.0f), para todos a la vez,
+    // donde w es la direccion del campo en la celda de cada uno (en la
+    // celda del caza es q-p, como en el enunciado). Los que no dan la
+    // vuelta no pueden atajar por el borde, para ellos w = q-p siempre
+    _flow.sample(want, pos);
+    Vec2 q = _flow.target();
+    for (std::size_t i = 0; i < n; i++)
+        if (!_followerWraps[i])
+            want.set(i, q - pos[i]);
+    const SinCos& r = fastrot::plus1();
+    vec2batch::turnTowards(vel, want, r.sin, r.cos);
+
+    for (std::size_t i = 0; i < n; i++)
+        _followers[i]->getVel().set(vel.x[i], vel.y[i]);
+}
+
+void SteeringSystem::updateSeekers() {
+    std::size_t n = _seekers.size();
+    if (n == 0) return;
+
+    _pos.resize(n);
+    _vel.resize(n);
+    _dist2.resize(n);
+    Vec2Span pos = _pos.span();
+    Vec2Span dir = _vel.span();
+    Vec2Span dests = _dests.span();
+
+    for (std::size_t i = 0; i < n; i++)
+        pos.set(i, toVec2(_seekers[i]->getPos()));
+
+    // dir = (dest - p), normalizada y escalada por la velocidad de cada uno
+    vec2batch::sub(dir, dests, pos);
+    vec2batch::lengthSq(_dist2.data(), dir);
+    vec2batch::normalizeOrZero(dir, dir);
+    vec2batch::scale(dir, dir, _speeds.data());
+
+    for (std::size_t i = 0; i < n; i++) {
+        _seekers[i]->getVel().set(dir.x[i], dir.y[i]);
+
+        // Si ha llegado al destino, elegir otro (como antes, la velocidad
+        // de este tick todavia apunta al destino anterior)
+        if (_dist2[i] < 5.0f * 5.0f)
+            dests.set(i, pickDestination());
+    }
+}
+
+void SteeringSystem::updateFlockers() {
+    std::size_t n = _flockers.size();
+    if (n == 0) return;
+
+    // Centros y velocidades (las que hayan dejado Follow/TowardDestination)
+    _pos.resize(n);
+    _vel.resize(n);
+    _want.resize(n);
+    Vec2Span pos = _pos.span();
+    Vec2Span vel = _vel.span();
+    Vec2Span out = _want.span();
+
+    for (std::size_t i = 0; i < n; i++) {
+        Transform* tr = _flockers[i];
+        pos.set(i, toVec2(tr->getPos()) + Vec2(tr->getWidth(), tr->getHeight()) * 0.5f);
+        vel.set(i, toVec2(tr->getVel()));
+    }
+
+    _grid.build(pos, _pool);
+
+    // Cada uno lee de pos/vel y escribe solo en out[i], asi que los trozos
+    // se pueden hacer en paralelo sin sincronizar nada. Se recorren en el
+    // orden de las celdas, para que consultas seguidas visiten las mismas
+    // celdas (mucho mejor para la cache cuando hay muchos asteroides)
+    auto body = [this, vel, out](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t k = begin; k < end; k++) {
+            std::size_t i = _grid.index()[k];
+            Vec2 p = _grid.sorted(k);
+            Vec2 v = vel[i];
+
+            Vec2 away;    // separacion: suma de (p-q)/d^2, mas fuerte cuanto mas cerca
+            Vec2 velSum;  // alineamiento: velocidad media de los vecinos
+            Vec2 posSum;  // cohesion: centro de los vecinos
+            int count = 0;
+
+            _grid.forEachNeighbor(p, FLOCK_RADIUS, [&](std::size_t j, Vec2 q, float d2) {
+                if (j == i || d2 == 0.0f) return;
+                away += (p - q) * (1.0f / d2);
+                velSum += vel[j];
+                posSum += q;
+                count++;
+            });
+
+            if (count == 0) {
+                out.set(i, v);
+                continue;
+            }
+
+            float inv = 1.0f / (float)count;
+            Vec2 steer = away * _separation[i]
+                + (velSum * inv - v) * _alignment[i]
+                + (posSum * inv - p) * _cohesion[i];
+
+            // Solo cambia la direccion, cada asteroide mantiene su velocidad
+            float speed = v.length();
+            out.set(i, (v + steer).normalizeOrZero() * speed);
+        }
+    };
+    _pool->parallelFor(n, body, 256);
+
+    for (std::size_t i = 0; i < n; i++)
+        _flockers[i]->getVel().set(out.x[i], out.y[i]);
+}
+
+Vec2 SteeringSystem::pickDestination() {
+    auto& rng = _world.rand();
+    return Vec2(
+        (float)rng.nextInt(50, (int)_world.width() - 50),
+        (float)rng.nextInt(50, (int)_world.height() - 50)
+    );
+}
@@ -0,0 +1,108 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../utils/FlowField.h"
+#include "../utils/NeighborGrid.h"
+#include "../utils/Vec2Batch.h"
+
+namespace ecs { class EntityManager; }
+class ThreadPool;
+class World;
+class Transform;
+struct Follow;
+struct TowardDestination;
+struct Flocking;
+
+// Sistema que mueve de una vez a todos los asteroides con Follow,
+// TowardDestination o Flocking. Los componentes solo se registran (initComponent) y
+// se dan de baja (destructor); el trabajo lo hace update(), una vez por
+// tick:
+//
+//  - lee la posicion del caza una sola vez y mueve el objetivo del campo
+//    de flujo (_flow) si ha cambiado de celda,
+//  - copia posiciones y velocidades a arrays SoA,
+//  - los Follow con WrapAround miran la celda del campo en la que estan,
+//    que indica el camino mas corto hacia el caza teniendo en cuenta que
+//    la pantalla da la vuelta; los demas (TeleportOnExit) no pueden atajar
+//    por el borde y usan q-p, como en el enunciado,
+//  - aplica los kernels de vec2batch (giro de +-1 grado decidido con el
+//    signo del producto vectorial, normalizacion hacia el destino),
+//  - y escribe las velocidades de vuelta en los Transform.
+//
+// Los Flocking van al final (corrigen la velocidad que hayan dejado los
+// anteriores): se reconstruye el indice de vecinos (_grid) con los centros
+// de todos ellos y cada uno se separa de, se alinea con y se acerca a los
+// que tiene a menos de FLOCK_RADIUS. Ambas cosas se reparten entre los
+// hilos del ThreadPool.
+//
+// Se llama despues de EntityManager::update(), que es cuando Follow y
+// TowardDestination hacian su trabajo en su propio update().
+
+class SteeringSystem {
+public:
+    // Radio de vecindad de Flocking (y tamanio de celda de _grid)
+    static constexpr float FLOCK_RADIUS = 100.0f;
+
+    SteeringSystem(World& world);
+    virtual ~SteeringSystem();
+
+    void addFollower(Follow* f, Transform* tr, bool wraps);
+    void removeFollower(Follow* f);
+
+    void addSeeker(TowardDestination* t, Transform* tr, float speed);
+    void removeSeeker(TowardDestination* t);
+
+    void addFlocker(Flocking* f, Transform* tr, float separation,
+        float alignment, float cohesion);
+    void removeFlocker(Flocking* f);
+
+    void update();
+
+    std::size_t numFollowers() const { return _followers.size(); }
+    std::size_t numSeekers() const { return _seekers.size(); }
+    std::size_t numFlockers() const { return _flockers.size(); }
+
+private:
+    void updateFollowers();
+    void updateSeekers();
+    void updateFlockers();
+    Vec2 pickDestination();
+
+    World&              _world;
+    ecs::EntityManager* _mngr;
+    ThreadPool*         _pool;
+
+    // Campo de flujo hacia el caza, compartido por los Follow con WrapAround
+    FlowField _flow;
+
+    // Follow: transform y componente (para actualizar su indice al borrar),
+    // y si da la vuelta a la pantalla (WrapAround) y puede usar _flow
+    std::vector<Transform*>   _followers;
+    std::vector<Follow*>      _followerCmps;
+    std::vector<std::uint8_t> _followerWraps;
+
+    // TowardDestination: ademas, destino y velocidad de cada uno
+    std::vector<Transform*>          _seekers;
+    std::vector<TowardDestination*> _seekerCmps;
+    Vec2Buffer                       _dests;
+    std::vector<float>               _speeds;
+
+    // Flocking: ademas, el peso de cada una de las tres reglas
+    std::vector<Transform*> _flockers;
+    std::vector<Flocking*>  _flockerCmps;
+    std::vector<float>      _separation;
+    std::vector<float>      _alignment;
+    std::vector<float>      _cohesion;
+
+    // Indice de vecinos de los Flocking, reconstruido en cada tick
+    NeighborGrid _grid;
+
+    // buffers reutilizados en cada tick
+    Vec2Buffer         _pos;
+    Vec2Buffer         _vel;
+    Vec2Buffer         _want;
+    std::vector<float> _dist2;
+};
@@ -0,0 +1,240 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "World.h"
+#include "FighterUtils.h"
+#include "AsteroidsUtils.h"
+#include "SteeringSystem.h"
+#include "ProjectileSystem.h"
+#include "ParticleSystem.h"
+#include "BoundsSystem.h"
+#include "CullingSystem.h"
+
+#include <algorithm>
+#include "../components/Transform.h"
+#include "../sdlutils/SDLUtils.h"
+#include "../utils/Collisions.h"
+#include "../utils/ThreadPool.h"
+#include "../utils/Vector2D.h"
+#include "ecs_defs.h"
+
+World::World(float width, float height, unsigned seed, ThreadPool* pool,
+    bool rendered) :
+    _width(width),
+    _height(height),
+    _destroyed(0),
+    _rand(seed),
+    _clock(),
+    _timers(),
+    _input(),
+    _pool(pool),
+    _ownsPool(pool == nullptr),
+    _mngr(nullptr),
+    _steering(nullptr),
+    _projectiles(nullptr),
+    _particles(nullptr),
+    _bounds(nullptr),
+    _culling(nullptr),
+    _fu(nullptr),
+    _au(nullptr),
+    _spawnTimer(TimerWheel::INVALID),
+    _explosion(&sdlutils().soundEffects().at("explosion"))
+{
+    if (_ownsPool)
+        _pool = new ThreadPool(0);
+
+    _mngr = new ecs::EntityManager(this);
+    _steering = new SteeringSystem(*this);
+    _projectiles = new ProjectileSystem(*this);
+    _projectiles->loadConfig("resources/config/asteroid.cfg.json");
+    // Con su propia semilla, para que tenerlas o no no cambie la partida
+    if (rendered)
+        _particles = new ParticleSystem(seed ^ 0x9e3779b9u);
+    _bounds = new BoundsSystem(*this);
+    _culling = new CullingSystem(*this);
+    _fu = new FighterUtils(*this);
+    _au = new AsteroidsUtils(*this);
+
+    _fu->create_fighter();
+}
+
+World::~World() {
+    delete _fu;
+    delete _au;
+    delete _mngr;  // antes que los sistemas: los componentes se dan de baja al destruirse
+    delete _steering;
+    delete _projectiles;
+    delete _particles;
+    delete _bounds;
+    delete _culling;
+    if (_ownsPool)
+        delete _pool;
+}
+
+// ---- Reloj ----
+
+void World::advanceClock() {
+    _clock.regCurrTime();
+    _timers.advance(_clock.currTime());
+}
+
+void World::advanceClock(Uint64 ms) {
+    _clock.step(ms);
+    _timers.advance(_clock.currTime());
+}
+
+// ---- Rondas ----
+
+void World::newRound() {
+    _fu->reset_fighter();
+    _au->remove_all_asteroids();
+    _au->create_asteroids(10);
+
+    _timers.cancel(_spawnTimer);
+    _spawnTimer = _timers.schedule(5000, [this]() { _au->create_asteroids(1); }, 5000);
+}
+
+void World::endRound() {
+    _timers.cancel(_spawnTimer);
+    _spawnTimer = TimerWheel::INVALID;
+}
+
+World::Event World::step() {
+    if (_au->count() == 0) {
+        endRound();
+        return NO_ASTEROIDS;
+    }
+
+    // Las balas se mueven antes que las entidades, asi las que dispare el
+    // caza en este tick salen desde la punta (como cuando el Gun las movia
+    // antes de disparar)
+    _projectiles->update();
+    _mngr->update();
+    _bounds->update();
+    _steering->update();
+    if (_particles != nullptr)
+        _particles->update();
+
+    Event e = checkCollisions();
+    if (e != NONE) {
+        endRound();
+        return e;
+    }
+
+    _mngr->refresh();
+    return NONE;
+}
+
+void World::render() {
+    // Lo que esta fuera de la pantalla ni se manda al SpriteBatch
+    _culling->update();
+
+    auto& cmds = sdlutils().commands();
+    cmds.setLayer(LAYER_ENTITIES);
+    _mngr->render();
+    cmds.setLayer(LAYER_PARTICLES);
+    if (_particles != nullptr)
+        _particles->render();
+    cmds.setLayer(LAYER_PROJECTILES);
+    _projectiles->render();
+}
+
+unsigned long World::simulate(unsigned long ticks) {
+    unsigned long rounds = 0;
+    bool playing = false;
+    bool gameOver = true;
+
+    for (unsigned long i = 0; i < ticks; i++) {
+        // Lo que harian NewGameState/NewRoundState al pulsar una tecla
+        if (!playing) {
+            if (gameOver)
+                _fu->reset_lives();
+            newRound();
+            playing = true;
+            rounds++;
+        }
+
+        // Tiempo virtual fijo por tick, no el real
+        advanceClock(TICK_MS);
+
+        Event e = step();
+        if (e != NONE) {
+            playing = false;
+            gameOver = (e == NO_ASTEROIDS || _fu->get_lives() <= 0);
+        }
+    }
+
+    endRound();
+    return rounds;
+}
+
+// ---- Colisiones ----
+
+World::Event World::checkCollisions() {
+    auto* fighter = _mngr->getHandler(ecs::hdlr::FIGHTER_HDLR);
+    if (fighter == nullptr || !fighter->isAlive()) return NONE;
+
+    auto* fighterTr = fighter->getComponent<Transform>();
+    if (fighterTr == nullptr) return NONE;
+
+    auto& asteroids = _mngr->getEntities(ecs::grp::ASTEROIDS);
+
+    // --- Balas vs Asteroides ---
+    // despawn(i) pone otra bala en i, asi que solo se avanza si no choca
+    auto& projectiles = *_projectiles;
+    std::size_t i = 0;
+    while (i < projectiles.size()) {
+        Vector2D bulletPos = toVector2D(projectiles.pos(i));
+        bool hit = false;
+        for (auto* asteroid : asteroids) {
+            if (!asteroid->isAlive()) continue;
+            auto* asTr = asteroid->getComponent<Transform>();
+            if (asTr == nullptr) continue;
+
+            hit = Collisions::collidesWithRotation(
+                bulletPos, projectiles.width(i), projectiles.height(i), projectiles.rot(i),
+                asTr->getPos(), asTr->getWidth(), asTr->getHeight(), 0.0f
+            );
+
+            if (hit) {
+                projectiles.despawn(i);
+                _destroyed++;
+                explode(asTr);
+                _au->split_astroid(asteroid);
+                _explosion->play();
+                break;
+            }
+        }
+        if (!hit) i++;
+    }
+
+    // --- Caza vs Asteroides ---
+    for (auto* asteroid : asteroids) {
+        if (!asteroid->isAlive()) continue;
+        auto* asTr = asteroid->getComponent<Transform>();
+        if (asTr == nullptr) continue;
+
+        bool hit = Collisions::collidesWithRotation(
+            fighterTr->getPos(), fighterTr->getWidth(), fighterTr->getHeight(), fighterTr->getRot(),
+            asTr->getPos(), asTr->getWidth(), asTr->getHeight(), 0.0f
+        );
+
+        if (hit) {
+            asteroid->setAlive(false);
+            explode(asTr);
+            explode(fighterTr);
+            _explosion->play();
+            _fu->update_lives(-1);
+            return FIGHTER_HIT;  // salir inmediatamente, no tocar mas entidades
+        }
+    }
+
+    return NONE;
+}
+
+void World::explode(Transform* tr) {
+    if (_particles == nullptr)
+        return;
+    float w = tr->getWidth(), h = tr->getHeight();
+    Vec2 center = toVec2(tr->getPos()) + Vec2(w, h) * 0.5f;
+    _particles->explosion(center, std::max(w, h) * 0.5f);
+}
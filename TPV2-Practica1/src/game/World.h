@@ -0,0 +1,136 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+#include <cstdint>
+#include "../ecs/EntityManager.h"
+#include "../sdlutils/RandomNumberGenerator.h"
+#include "../sdlutils/VirtualTimer.h"
+#include "../utils/TimerWheel.h"
+#include "InputSnapshot.h"
+
+class SoundEffect;
+class ThreadPool;
+class SteeringSystem;
+class ProjectileSystem;
+class ParticleSystem;
+class BoundsSystem;
+class CullingSystem;
+class FighterUtils;
+class AsteroidsUtils;
+class Transform;
+
+// Todo lo que necesita una partida para simularse: las entidades, los
+// numeros aleatorios, el reloj (virtual) y sus timers, el tamanio del
+// mundo, la entrada y los sistemas. Las entidades lo tienen a mano con
+// _ent->getWorld(), asi que los componentes no usan objetos globales y
+// puede haber varias partidas a la vez, cada una en su hilo (ver
+// Game::startHeadless).
+//
+// Los recursos (imagenes, animaciones, sonidos) si son globales, de
+// sdlutils(), porque solo se leen.
+//
+// Game tiene un World y lo usa a traves de sus estados: RunningState
+// llama a step() y render() en cada iteracion del bucle.
+
+class World {
+public:
+    // Resultado de un tick de simulacion
+    enum Event {
+        NONE,
+        FIGHTER_HIT,   // un asteroide ha chocado con el caza (vida perdida)
+        NO_ASTEROIDS   // no quedan asteroides
+    };
+
+    // Capas de la lista de comandos (ver RenderList::setLayer), de abajo a
+    // arriba. Dentro de cada capa los sprites se ordenan por textura
+    enum Layer : std::uint8_t {
+        LAYER_ENTITIES,
+        LAYER_PARTICLES,
+        LAYER_PROJECTILES,
+        LAYER_HUD
+    };
+
+    static constexpr int TICK_MS = 10;  // duracion de un tick de simulate()
+
+    // 'pool' se comparte y no se borra; si es nullptr el mundo usa uno
+    // propio sin hilos (para cuando hay un mundo por hilo). Un mundo que no
+    // se pinta (rendered=false, sin ventana o en un BatchEnv) no tiene
+    // particulas: getParticles() es nullptr
+    World(float width, float height, unsigned seed, ThreadPool* pool = nullptr,
+        bool rendered = true);
+    virtual ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    inline ecs::EntityManager* getMngr() { return _mngr; }
+    inline RandomNumberGenerator& rand() { return _rand; }
+    inline VirtualTimer& clock() { return _clock; }
+    inline TimerWheel& timers() { return _timers; }
+    inline InputSnapshot& input() { return _input; }
+    inline float width() const { return _width; }
+    inline float height() const { return _height; }
+
+    // Asteroides alcanzados por una bala desde que se creo el mundo
+    inline unsigned long destroyed() const { return _destroyed; }
+
+    inline ThreadPool* getThreadPool() { return _pool; }
+    inline SteeringSystem* getSteering() { return _steering; }
+    inline ProjectileSystem* getProjectiles() { return _projectiles; }
+    inline ParticleSystem* getParticles() { return _particles; }
+    inline BoundsSystem* getBounds() { return _bounds; }
+    inline CullingSystem* getCulling() { return _culling; }
+    inline FighterUtils* getFighter() { return _fu; }
+    inline AsteroidsUtils* getAsteroids() { return _au; }
+
+    // Reloj: con el tiempo real (el del VirtualTimer) o con uno fijo por
+    // tick. En ambos casos avanzan los timers.
+    void advanceClock();
+    void advanceClock(Uint64 ms);
+
+    // Caza en el centro, asteroides nuevos y uno mas cada 5 segundos
+    void newRound();
+
+    // Un tick: balas, entidades, sistemas, colisiones. Si devuelve algo
+    // distinto de NONE la ronda ha terminado (no se ha llamado a refresh)
+    Event step();
+
+    void render();
+
+    // Sin ventana ni entrada: 'ticks' ticks de TICK_MS, empezando rondas y
+    // partidas nuevas cuando terminan. Devuelve cuantas rondas ha jugado
+    unsigned long simulate(unsigned long ticks);
+
+    // Explosion de particulas del tamanio de la entidad
+    void explode(Transform* tr);
+
+private:
+    Event checkCollisions();
+    void endRound();
+
+    float _width;
+    float _height;
+
+    unsigned long _destroyed;
+
+    RandomNumberGenerator _rand;
+    VirtualTimer          _clock;
+    TimerWheel            _timers;
+    InputSnapshot         _input;
+
+    ThreadPool* _pool;
+    bool        _ownsPool;
+
+    ecs::EntityManager* _mngr;
+    SteeringSystem*     _steering;     // Follow, TowardDestination y Flocking
+    ProjectileSystem*   _projectiles;  // balas de todas las armas
+    ParticleSystem*     _particles;    // explosiones y motor del caza (o nullptr)
+    BoundsSystem*       _bounds;       // WrapAround y TeleportOnExit
+    CullingSystem*      _culling;      // que sprites se ven
+    FighterUtils*       _fu;
+    AsteroidsUtils*     _au;
+
+    TimerWheel::TimerId _spawnTimer;  // un asteroide cada 5 segundos
+
+    const SoundEffect* _explosion;  // buscado una vez (ver ResourceCache)
+};
@@ -18,7 +18,8 @@
 	TELEPORTONEXIT, \
 	FOLLOW, \
 	TOWARDDESTINATION, \
-	MATERIALCONSISTENCY
+	MATERIALCONSISTENCY, \
+	FLOCKING
 
 #define _GRPS_LIST_ \
 	ASTEROIDS, \
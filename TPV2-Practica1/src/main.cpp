@@ -1,12 +1,98 @@
 // This file is part of the course TPV2@UCM - Samir Genaim
 
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
 #include "game/Game.h"
+#include "sdlutils/ResourceArchive.h"
+
+// Uso: TPV2 [--headless TICKS] [--worlds N | --envs K] [--seed S]
+//           [--size ANCHO ALTO] [--fps F | --vsync]
+//        TPV2 --pack
+//
+// Con --headless no se abre ventana ni audio: se simulan TICKS ticks tan
+// rapido como se pueda (pruebas largas, benchmarks, maquinas sin pantalla).
+// --worlds simula N partidas independientes a la vez, una por hilo, con
+// semillas S, S+1, ... (por defecto S sale de la hora).
+// --envs mide un BatchEnv de K partidas con acciones aleatorias (el
+// ThreadPool reparte las partidas entre los nucleos).
+// --size cambia el tamanio de la ventana (o del mundo sin ventana).
+// --fps limita los frames por segundo a F (0 es sin limite; por defecto
+// 100, uno por tick) y --vsync los sincroniza con la pantalla. La
+// simulacion va igual en todos los casos.
+// --pack empaqueta las imagenes, sonidos y fuentes ya decodificados en el
+// archivo que indica el fichero de recursos (ver ResourceArchive); si
+// existe, el juego los carga de ahi, sin leer ni decodificar cada fichero.
+
+int main(int argc, char** argv) {
+    bool headless = false;
+    unsigned long ticks = 0;
+    int worlds = 1;
+    int envs = 0;
+    unsigned seed = (unsigned)std::time(nullptr);
+    int width = 800, height = 600;
+    int fps = 100;
+    bool vsync = false;
+    bool pack = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--headless") == 0 && i + 1 < argc) {
+            headless = true;
+            ticks = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--worlds") == 0 && i + 1 < argc) {
+            worlds = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--envs") == 0 && i + 1 < argc) {
+            envs = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 2 < argc) {
+            width = std::atoi(argv[++i]);
+            height = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            fps = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--vsync") == 0) {
+            vsync = true;
+        }
+        else if (std::strcmp(argv[i], "--pack") == 0) {
+            pack = true;
+        }
+        else {
+            std::cerr << "Uso: " << argv[0]
+                << " [--headless TICKS] [--worlds N | --envs K] [--seed S]"
+                << " [--size ANCHO ALTO] [--fps F | --vsync]"
+                << std::endl
+                << "     " << argv[0] << " --pack" << std::endl;
+            return 1;
+        }
+    }
+    if (width <= 0 || height <= 0) {
+        std::cerr << "Tamanio no valido." << std::endl;
+        return 1;
+    }
+    if (fps < 0) {
+        std::cerr << "Numero de frames por segundo no valido." << std::endl;
+        return 1;
+    }
+    if (worlds < 1 || envs < 0) {
+        std::cerr << "Numero de mundos o de partidas no valido." << std::endl;
+        return 1;
+    }
 
-int main(int, char**) {
     try {
+        // Solo empaquetar los recursos
+        if (pack) {
+            ResourceArchive::build(Game::RESOURCES);
+            return 0;
+        }
+
         // Inicializar SDL (SDLUtils + InputHandler)
-        if (!Game::Init()) {
+        if (!Game::Init(headless, width, height)) {
             std::cerr << "No se pudo inicializar el juego." << std::endl;
             return 1;
         }
@@ -15,7 +101,19 @@ int main(int, char**) {
         Game::Instance()->initGame();
 
         // Bucle principal
-        Game::Instance()->start();
+        if (headless && envs > 0)
+            Game::Instance()->startBatchEnv(ticks, envs, seed);
+        else if (headless)
+            Game::Instance()->startHeadless(ticks, worlds, seed);
+        else {
+            if (vsync)
+                Game::Instance()->setPacing(FramePacer::VSYNC);
+            else if (fps == 0)
+                Game::Instance()->setPacing(FramePacer::UNLIMITED);
+            else
+                Game::Instance()->setPacing(FramePacer::FIXED, fps);
+            Game::Instance()->start();
+        }
 
         // Liberar singleton
         Game::Release();
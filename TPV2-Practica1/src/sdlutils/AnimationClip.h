@@ -0,0 +1,87 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <SDL.h>
+#include <cassert>
+#include <vector>
+
+#include "RenderList.h"
+#include "Texture.h"
+
+/*
+ * An animation clip of a sprite-sheet: the frames are a grid of 'cols'
+ * columns, the i-th frame is at column i%cols and row i/cols, and each one
+ * is shown for the same time.
+ *
+ * Clips are shared (they are loaded once, into sdlutils().animations()),
+ * and they do not keep any time: the frame to show is computed from a time
+ * that is common to all objects, e.g., the one of the virtual timer. An
+ * object that uses a clip only needs a pointer to it and a phase (the
+ * frame it shows at time 0), so objects that share a clip do not all show
+ * the same frame.
+ */
+class AnimationClip {
+public:
+
+	// 'frames' is the number of frames, at most cols*rows (the last row of
+	// the sheet might not be complete); (stepX,stepY) is the distance
+	// between consecutive frames and (frameW,frameH) the size of each
+	// frame, both in pixels.
+	//
+	AnimationClip(const Texture &texture, int cols, int frames, float stepX,
+			float stepY, float frameW, float frameH, float fps) :
+			_texture(&texture), //
+			_frameTime(static_cast<Uint64>(1000.0f / fps)), //
+			_frames() {
+		assert(cols > 0 && frames > 0 && fps > 0.0f);
+		if (_frameTime == 0)
+			_frameTime = 1;
+		_frames.reserve(frames);
+		for (int i = 0; i < frames; i++)
+			_frames.push_back(SDL_FRect { (i % cols) * stepX, (i / cols)
+					* stepY, frameW, frameH });
+	}
+
+	virtual ~AnimationClip() {
+	}
+
+	inline const Texture& texture() const {
+		return *_texture;
+	}
+
+	inline int numFrames() const {
+		return static_cast<int>(_frames.size());
+	}
+
+	// milliseconds each frame is shown
+	inline Uint64 frameTime() const {
+		return _frameTime;
+	}
+
+	// the index of the frame to show at time 'time' (in milliseconds)
+	inline int frameAt(Uint64 time, int phase = 0) const {
+		return static_cast<int>((time / _frameTime + phase) % _frames.size());
+	}
+
+	// the source rectangle of the i-th frame
+	inline const SDL_FRect& frame(int i) const {
+		return _frames[i];
+	}
+
+	// renders the frame that corresponds to 'time' at 'dest'
+	inline void render(const SDL_FRect &dest, Uint64 time, int phase = 0) const {
+		_texture->render(_frames[frameAt(time, phase)], dest);
+	}
+
+	// the same, but recording the frame in a list of render commands
+	inline void render(RenderList &cmds, const SDL_FRect &dest, Uint64 time,
+			int phase = 0) const {
+		cmds.draw(*_texture, _frames[frameAt(time, phase)], dest);
+	}
+
+private:
+	const Texture *_texture;
+	Uint64 _frameTime;
+	std::vector<SDL_FRect> _frames; // source rectangles, precomputed
+};
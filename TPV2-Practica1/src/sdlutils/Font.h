@@ -40,6 +40,13 @@ public:
 		assert(_font != nullptr);
 	}
 
+	// from a stream (e.g., a file in memory, see ResourceArchive), closed
+	// with the font -- the memory must outlive the font
+	Font(SDL_IOStream *io, float size) {
+		_font = TTF_OpenFontIO(io, true, size);
+		assert(_font != nullptr);
+	}
+
 	virtual ~Font() {
 		if (_font != nullptr)
 			TTF_CloseFont(_font);
@@ -57,6 +64,35 @@ public:
 		return TTF_RenderText_Shaded(_font, text.c_str(), 0, fgColor, bgColor);
 	}
 
+	// a single character, as renderText would draw it
+	inline SDL_Surface* renderGlyph(Uint32 ch, SDL_Color fgColor) const {
+		assert(_font != nullptr);
+		return TTF_RenderGlyph_Solid(_font, ch, fgColor);
+	}
+
+	// how much the pen moves after drawing 'ch', in pixels
+	inline int glyphAdvance(Uint32 ch) const {
+		assert(_font != nullptr);
+		int advance = 0;
+		TTF_GetGlyphMetrics(_font, ch, nullptr, nullptr, nullptr, nullptr,
+				&advance);
+		return advance;
+	}
+
+	// extra distance between 'prev' and 'ch' when they are consecutive
+	inline int kerning(Uint32 prev, Uint32 ch) const {
+		assert(_font != nullptr);
+		int k = 0;
+		TTF_GetGlyphKerning(_font, prev, ch, &k);
+		return k;
+	}
+
+	// height of a line of text
+	inline int height() const {
+		assert(_font != nullptr);
+		return TTF_GetFontHeight(_font);
+	}
+
 private:
 	TTF_Font *_font;
 }
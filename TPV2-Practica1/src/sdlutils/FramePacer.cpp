@@ -0,0 +1,136 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cassert>
+
+// ---- FrameTimeHistogram ----
+
+FrameTimeHistogram::FrameTimeHistogram() :
+		_buckets(NUM_BUCKETS, 0), //
+		_count(0), //
+		_total(0), //
+		_max(0) {
+}
+
+FrameTimeHistogram::~FrameTimeHistogram() {
+}
+
+void FrameTimeHistogram::add(Uint64 ns) {
+	std::size_t b = std::min(static_cast<std::size_t>(ns / BUCKET_NS),
+			NUM_BUCKETS - 1);
+	_buckets[b]++;
+	_count++;
+	_total += ns;
+	_max = std::max(_max, ns);
+}
+
+void FrameTimeHistogram::clear() {
+	std::fill(_buckets.begin(), _buckets.end(), 0);
+	_count = 0;
+	_total = 0;
+	_max = 0;
+}
+
+Uint64 FrameTimeHistogram::percentile(double p) const {
+	if (_count == 0)
+		return 0;
+
+	// the first bucket where the cumulative count reaches p*count
+	std::size_t target = static_cast<std::size_t>(p * _count);
+	if (target < 1)
+		target = 1;
+	std::size_t sum = 0;
+	for (std::size_t b = 0; b < NUM_BUCKETS - 1; b++) {
+		sum += _buckets[b];
+		if (sum >= target)
+			return std::min((b + 1) * BUCKET_NS, _max);
+	}
+	return _max;
+}
+
+void FrameTimeHistogram::dump(std::ostream &out) const {
+	auto ms = [](Uint64 ns) {
+		return ns / 1e6;
+	};
+	out << "frames: " << _count << ", mean " << ms(mean()) << " ms, p50 "
+			<< ms(percentile(0.5)) << " ms, p99 " << ms(percentile(0.99))
+			<< " ms, p99.9 " << ms(percentile(0.999)) << " ms, max "
+			<< ms(_max) << " ms" << std::endl;
+}
+
+// ---- FramePacer ----
+
+// limits of the margin before the deadline where sleeping stops
+static constexpr Uint64 MIN_MARGIN_NS = 50000; // 50 us
+static constexpr Uint64 MAX_MARGIN_NS = 4000000; // 4 ms
+
+FramePacer::FramePacer() :
+		_mode(FIXED), //
+		_period(10000000), //
+		_deadline(0), //
+		_frameStart(0), //
+		_margin(1000000), //
+		_lastLateness(0), //
+		_histogram() {
+}
+
+FramePacer::~FramePacer() {
+}
+
+void FramePacer::setMode(Mode mode, int fps, SDL_Renderer *renderer) {
+	assert(mode != FIXED || fps > 0);
+	_mode = mode;
+	if (mode == FIXED)
+		_period = 1000000000ull / static_cast<Uint64>(fps);
+	if (renderer != nullptr)
+		SDL_SetRenderVSync(renderer, mode == VSYNC ? 1 : 0);
+}
+
+void FramePacer::start() {
+	_frameStart = SDL_GetTicksNS();
+	_deadline = _frameStart;
+	_lastLateness = 0;
+}
+
+void FramePacer::endFrame() {
+	_lastLateness = 0;
+	if (_mode == FIXED) {
+		_deadline += _period;
+		Uint64 now = SDL_GetTicksNS();
+		if (now < _deadline)
+			waitUntil(_deadline);
+		else if (now - _deadline > _period)
+			_deadline = now; // too late, start again from here
+	}
+
+	Uint64 end = SDL_GetTicksNS();
+	_histogram.add(end - _frameStart);
+	_frameStart = end;
+}
+
+void FramePacer::waitUntil(Uint64 deadline) {
+	Uint64 now = SDL_GetTicksNS();
+
+	// sleep the coarse part, and learn how much the sleep overshoots
+	if (deadline - now > _margin) {
+		Uint64 asked = deadline - now - _margin;
+		SDL_DelayNS(asked);
+		Uint64 after = SDL_GetTicksNS();
+		Uint64 slept = after - now;
+		Uint64 over = slept > asked ? slept - asked : 0;
+
+		// the margin follows twice the overshoot: it grows at once when a
+		// sleep overshoots more, and shrinks slowly
+		Uint64 want = std::min(std::max(2 * over, MIN_MARGIN_NS),
+				MAX_MARGIN_NS);
+		_margin = want > _margin ? want : (7 * _margin + want) / 8;
+		now = after;
+	}
+
+	// spin for the rest
+	while (now < deadline)
+		now = SDL_GetTicksNS();
+	_lastLateness = now - deadline;
+}
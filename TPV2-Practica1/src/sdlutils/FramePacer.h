@@ -0,0 +1,124 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/*
+ * Histogram of frame times, with buckets of 10 microseconds up to 100 ms
+ * (longer frames go to the last bucket, and the maximum is kept apart).
+ * Percentiles are the upper end of the bucket where they fall, so they are
+ * exact to 10 microseconds.
+ */
+class FrameTimeHistogram {
+public:
+
+	static constexpr Uint64 BUCKET_NS = 10000; // 10 us
+	static constexpr std::size_t NUM_BUCKETS = 10000; // up to 100 ms
+
+	FrameTimeHistogram();
+	virtual ~FrameTimeHistogram();
+
+	void add(Uint64 ns);
+	void clear();
+
+	// the frame time (in nanoseconds) below which there are a fraction 'p'
+	// of the frames, e.g., percentile(0.99)
+	//
+	Uint64 percentile(double p) const;
+
+	inline std::size_t count() const {
+		return _count;
+	}
+
+	inline Uint64 max() const {
+		return _max;
+	}
+
+	inline Uint64 mean() const {
+		return _count > 0 ? _total / _count : 0;
+	}
+
+	// frames, mean, p50, p99, p99.9 and max, in milliseconds
+	//
+	void dump(std::ostream &out) const;
+
+private:
+	std::vector<std::uint32_t> _buckets;
+	std::size_t _count;
+	Uint64 _total;
+	Uint64 _max;
+};
+
+/*
+ * Decides when each frame ends, with times in nanoseconds (SDL_GetTicksNS),
+ * in one of three modes:
+ *
+ * - VSYNC: presenting the renderer waits for the vertical retrace (it is
+ *   enabled with SDL_SetRenderVSync), the pacer does not wait,
+ * - FIXED: frames end at fixed deadlines, 1/fps apart. The deadlines do
+ *   not drift, a late frame just makes the next one shorter, and when a
+ *   frame is later than a whole period the deadlines start again from it,
+ * - UNLIMITED: no waiting at all.
+ *
+ * To hit a deadline it sleeps (SDL_DelayNS) until a little before it and
+ * spins for the rest. The margin adapts to how much the sleeps of this
+ * machine overshoot, so it spins as little as possible and still wakes up
+ * within tens of microseconds of the deadline.
+ *
+ * Every frame time (from the end of a frame to the end of the next one) is
+ * added to a histogram.
+ */
+class FramePacer {
+public:
+
+	enum Mode {
+		VSYNC, FIXED, UNLIMITED
+	};
+
+	FramePacer();
+	virtual ~FramePacer();
+
+	// For FIXED, 'fps' frames per second. If 'renderer' is not nullptr its
+	// vsync is turned on or off according to the mode.
+	//
+	void setMode(Mode mode, int fps = 100, SDL_Renderer *renderer = nullptr);
+
+	inline Mode mode() const {
+		return _mode;
+	}
+
+	// Call it right before the first frame.
+	//
+	void start();
+
+	// Call it at the end of each frame: waits until the frame has to end
+	// (in mode FIXED) and records its time.
+	//
+	void endFrame();
+
+	inline const FrameTimeHistogram& histogram() const {
+		return _histogram;
+	}
+
+	// by how much the last wait missed its deadline (0 if not FIXED, or if
+	// there was no need to wait)
+	inline Uint64 lastLateness() const {
+		return _lastLateness;
+	}
+
+private:
+	void waitUntil(Uint64 deadline);
+
+	Mode _mode;
+	Uint64 _period; // in FIXED
+	Uint64 _deadline; // of the current frame
+	Uint64 _frameStart;
+	Uint64 _margin; // sleep until this much before the deadline, then spin
+	Uint64 _lastLateness;
+	FrameTimeHistogram _histogram;
+};
@@ -25,6 +25,7 @@ public:
 	// clear the state
 	inline void clearState() {
 		_isCloseWindoEvent = false;
+		_isRenderTargetsResetEvent = false;
 		_isKeyDownEvent = false;
 		_isKeyUpEvent = false;
 
@@ -55,16 +56,28 @@ public:
 		case SDL_EVENT_WINDOW_CLOSE_REQUESTED:
 			handleWindowCloseRequestEvent();
 			break;
+		case SDL_EVENT_RENDER_TARGETS_RESET:
+		case SDL_EVENT_RENDER_DEVICE_RESET:
+			_isRenderTargetsResetEvent = true;
+			break;
 		default:
 			break;
 		}
 	}
 
-	// refresh
-	inline void refresh() {
+	// refresh: clear the state and read the pending events. With
+	// keepInputEvents=true only the window events are cleared, the keyboard
+	// and mouse ones of previous calls are kept (until clearState) for
+	// when nobody has looked at them yet
+	inline void refresh(bool keepInputEvents = false) {
 		SDL_Event event;
 
-		clearState();
+		if (keepInputEvents) {
+			_isCloseWindoEvent = false;
+			_isRenderTargetsResetEvent = false;
+		} else {
+			clearState();
+		}
 		while (SDL_PollEvent(&event))
 			update(event);
 	}
@@ -74,6 +87,11 @@ public:
 		return _isCloseWindoEvent;
 	}
 
+	// the contents of the render targets have been lost
+	inline bool renderTargetsResetEvent() {
+		return _isRenderTargetsResetEvent;
+	}
+
 	// keyboard
 	inline bool keyDownEvent() {
 		return _isKeyDownEvent;
@@ -197,6 +215,7 @@ private:
 	}
 
 	bool _isCloseWindoEvent;
+	bool _isRenderTargetsResetEvent;
 	bool _isKeyUpEvent;
 	bool _isKeyDownEvent;
 	bool _isMouseMotionEvent;
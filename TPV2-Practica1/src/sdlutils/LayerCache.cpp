@@ -0,0 +1,44 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "LayerCache.h"
+
+#include <cassert>
+
+LayerCache::LayerCache() :
+		_renderer(nullptr), //
+		_width(0), //
+		_height(0), //
+		_layers(), //
+		_numRedraws(0) {
+}
+
+LayerCache::~LayerCache() {
+}
+
+const Texture& LayerCache::get(std::uint32_t id, std::uint64_t version,
+		bool &stale) {
+	assert(_renderer != nullptr);
+
+	auto it = _layers.find(id);
+	if (it == _layers.end())
+		it = _layers.emplace(id,
+				Layer { Texture(_renderer, _width, _height), version, false }).first;
+
+	Layer &l = it->second;
+	stale = !l.valid || l.version != version;
+	if (stale) {
+		l.version = version;
+		l.valid = true;
+		_numRedraws++;
+	}
+	return l.texture;
+}
+
+void LayerCache::invalidate() {
+	for (auto &l : _layers)
+		l.second.valid = false;
+}
+
+void LayerCache::clear() {
+	_layers.clear();
+}
@@ -0,0 +1,77 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "Texture.h"
+
+/*
+ * Render targets for layers that change rarely (a HUD, a menu screen):
+ * each layer, identified by a number, is rendered to its own texture of
+ * the size of the window, and drawn from there in the following frames.
+ *
+ * A layer comes with a version, any number that changes when what is in
+ * the layer changes (e.g., built from the number of lives). get() tells
+ * whether the texture was rendered with a different version, the only case
+ * in which it has to be rendered again. RenderList::beginCached() is the
+ * way to use it.
+ *
+ * The textures must be destroyed before the renderer, see clear().
+ */
+class LayerCache {
+public:
+
+	LayerCache();
+	virtual ~LayerCache();
+
+	LayerCache(const LayerCache&) = delete;
+	LayerCache& operator=(const LayerCache&) = delete;
+
+	// The renderer and the size of the textures, must be set before using
+	// the other methods.
+	//
+	inline void setRenderer(SDL_Renderer *renderer, int width, int height) {
+		_renderer = renderer;
+		_width = width;
+		_height = height;
+	}
+
+	// The texture of layer 'id'. 'stale' is set to true if it has to be
+	// rendered (it is new, or was rendered with another version), and from
+	// then on the texture counts as rendered with 'version'.
+	//
+	const Texture& get(std::uint32_t id, std::uint64_t version, bool &stale);
+
+	// All the layers have to be rendered again, e.g., when the contents of
+	// the render targets have been lost (SDL_EVENT_RENDER_TARGETS_RESET).
+	//
+	void invalidate();
+
+	// Destroys all the textures.
+	//
+	void clear();
+
+	// Number of times a layer has been rendered, to check that in steady
+	// state it does not grow.
+	//
+	inline std::size_t numRedraws() const {
+		return _numRedraws;
+	}
+
+private:
+	struct Layer {
+		Texture texture;
+		std::uint64_t version;
+		bool valid;
+	};
+
+	SDL_Renderer *_renderer;
+	int _width;
+	int _height;
+	std::unordered_map<std::uint32_t, Layer> _layers;
+	std::size_t _numRedraws;
+};
@@ -0,0 +1,247 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "RenderList.h"
+
+#include <cassert>
+
+#include "Font.h"
+#include "LayerCache.h"
+#include "SpriteBatch.h"
+#include "TextRenderer.h"
+#include "Texture.h"
+#include "../utils/RadixSort.h"
+
+RenderList::RenderList() :
+		_cmds(), //
+		_nested(), //
+		_cachedBegin(NOT_CACHED), //
+		_cachedId(0), //
+		_cachedVersion(0), //
+		_chars(), //
+		_layer(0), //
+		_textures(), //
+		_lastTexture(0), //
+		_keys(), //
+		_order(), //
+		_tmpKeys(), //
+		_tmpOrder(), //
+		_str() {
+}
+
+RenderList::~RenderList() {
+}
+
+void RenderList::reset() {
+	assert(_cachedBegin == NOT_CACHED);
+	_cmds.clear();
+	_nested.clear();
+	_chars.clear();
+	_layer = 0;
+	_textures.clear();
+	_lastTexture = 0;
+}
+
+void RenderList::record(const Command &c) {
+	if (_cachedBegin == NOT_CACHED)
+		_cmds.push_back(c);
+	else
+		_nested.push_back(c);
+}
+
+std::uint64_t RenderList::key(const void *tex) {
+	if (_lastTexture >= _textures.size() || _textures[_lastTexture] != tex) {
+		std::size_t i = 0;
+		while (i < _textures.size() && _textures[i] != tex)
+			i++;
+		if (i == _textures.size()) {
+			if (i < MAX_TEXTURES)
+				_textures.push_back(tex);
+			else
+				i = MAX_TEXTURES - 1; // they share a key, only not grouped
+		}
+		_lastTexture = i;
+	}
+	return (std::uint64_t(_layer) << LAYER_SHIFT)
+			| (std::uint64_t(_lastTexture + 1) << TEXTURE_SHIFT);
+}
+
+void RenderList::clear(SDL_Color color) {
+	Command c;
+	assert(_cachedBegin == NOT_CACHED);
+	c.type = CLEAR;
+	c.key = 0; // before everything
+	c.clear = color;
+	record(c);
+}
+
+void RenderList::draw(const Texture &tex, const SDL_FRect &src,
+		const SDL_FRect &dest, float angle, SDL_FColor color) {
+	Command c;
+	c.type = SPRITE;
+	// a texture that is not loaded yet (see ResourceCache) has no SDL texture
+	if (tex.sdlTexture() != nullptr)
+		c.key = key(tex.sdlTexture());
+	else
+		c.key = key(&tex);
+	c.sprite = Sprite { &tex, src, dest, angle, color };
+	record(c);
+}
+
+void RenderList::draw(const Texture &tex, const SDL_FRect &dest,
+		float angle) {
+	// the size is taken when it is rendered, the texture might be loaded
+	// only then
+	draw(tex, SDL_FRect { 0.0f, 0.0f, -1.0f, -1.0f }, dest, angle);
+}
+
+void RenderList::text(const Font &font, const std::string &text, float x,
+		float y, SDL_Color color, Align align) {
+	addText(TEXT, font, text, x, y, color, align);
+}
+
+void RenderList::cachedText(const Font &font, const std::string &text,
+		float x, float y, SDL_Color color, Align align) {
+	addText(CACHED_TEXT, font, text, x, y, color, align);
+}
+
+void RenderList::addText(Type type, const Font &font,
+		const std::string &text, float x, float y, SDL_Color color,
+		Align align) {
+	Command c;
+	c.type = type;
+	c.key = key(&font); // the texture is not known yet
+	c.text = Text { &font, static_cast<std::uint32_t>(_chars.size()),
+			static_cast<std::uint32_t>(text.size()), x, y, color, align };
+	_chars.insert(_chars.end(), text.begin(), text.end());
+	record(c);
+}
+
+void RenderList::beginCached(std::uint32_t id, std::uint64_t version) {
+	assert(_cachedBegin == NOT_CACHED);
+	_cachedBegin = static_cast<std::uint32_t>(_nested.size());
+	_cachedId = id;
+	_cachedVersion = version;
+}
+
+void RenderList::endCached() {
+	assert(_cachedBegin != NOT_CACHED);
+	Command c;
+	c.type = CACHED;
+	// the texture is not known yet, it goes below the others of the layer
+	c.key = std::uint64_t(_layer) << LAYER_SHIFT;
+	c.cached = Cached { _cachedId, _cachedBegin,
+			static_cast<std::uint32_t>(_nested.size()) - _cachedBegin,
+			_cachedVersion };
+	_cachedBegin = NOT_CACHED;
+	_cmds.push_back(c);
+}
+
+void RenderList::sort() {
+	std::size_t n = _cmds.size();
+	_keys.resize(n);
+	_order.resize(n);
+	_tmpKeys.resize(n);
+	_tmpOrder.resize(n);
+	for (std::size_t i = 0; i < n; i++) {
+		_keys[i] = _cmds[i].key;
+		_order[i] = static_cast<std::uint32_t>(i);
+	}
+	radix::sort(_keys.data(), _order.data(), n, _tmpKeys.data(),
+			_tmpOrder.data());
+}
+
+void RenderList::submit(SDL_Renderer *renderer, SpriteBatch &batch,
+		TextRenderer &text, LayerCache &layers) {
+	assert(_cachedBegin == NOT_CACHED);
+	sort();
+
+	std::uint64_t layer = 0;
+	for (std::uint32_t i : _order) {
+		const Command &c = _cmds[i];
+
+		// the layers below are drawn before this one
+		std::uint64_t l = c.key >> LAYER_SHIFT;
+		if (l != layer) {
+			batch.flush();
+			layer = l;
+		}
+
+		if (c.type == CACHED)
+			submitCached(c.cached, renderer, batch, text, layers);
+		else
+			submit(c, renderer, batch, text);
+	}
+	batch.flush();
+}
+
+void RenderList::submitCached(const Cached &k, SDL_Renderer *renderer,
+		SpriteBatch &batch, TextRenderer &text, LayerCache &layers) {
+	bool stale;
+	const Texture &tex = layers.get(k.id, k.version, stale);
+
+	if (stale) {
+		// everything before goes to the screen, what comes now to the layer
+		batch.flush();
+		SDL_SetRenderTarget(renderer, tex.sdlTexture());
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+		SDL_RenderClear(renderer);
+		for (std::uint32_t i = 0; i < k.count; i++)
+			submit(_nested[k.begin + i], renderer, batch, text);
+		batch.flush();
+		SDL_SetRenderTarget(renderer, nullptr);
+	}
+
+	batch.draw(tex, SDL_FRect { 0.0f, 0.0f, static_cast<float>(tex.width()),
+			static_cast<float>(tex.height()) });
+}
+
+void RenderList::submit(const Command &c, SDL_Renderer *renderer,
+		SpriteBatch &batch, TextRenderer &text) {
+	switch (c.type) {
+	case CLEAR:
+		batch.flush(); // what was drawn before is cleared too
+		SDL_SetRenderDrawColor(renderer, c.clear.r, c.clear.g, c.clear.b,
+				c.clear.a);
+		SDL_RenderClear(renderer);
+		break;
+	case SPRITE: {
+		const Sprite &s = c.sprite;
+		if (s.tex->sdlTexture() == nullptr)
+			break; // not loaded (yet), nothing to draw
+		if (s.src.w < 0.0f)
+			batch.draw(*s.tex,
+					SDL_FRect { 0.0f, 0.0f, static_cast<float>(s.tex->width()),
+							static_cast<float>(s.tex->height()) }, s.dest,
+					s.angle, s.color);
+		else
+			batch.draw(*s.tex, s.src, s.dest, s.angle, s.color);
+		break;
+	}
+	case TEXT:
+	case CACHED_TEXT: {
+		const Text &t = c.text;
+		_str.assign(_chars.data() + t.begin, t.length);
+		float x = t.x, y = t.y;
+		if (c.type == TEXT) {
+			if (t.align == CENTER) {
+				x -= text.width(*t.font, _str) / 2.0f;
+				y -= text.height(*t.font) / 2.0f;
+			}
+			text.draw(batch, *t.font, _str, x, y, t.color);
+		} else {
+			const Texture &tex = text.cached(*t.font, _str, t.color);
+			float w = static_cast<float>(tex.width());
+			float h = static_cast<float>(tex.height());
+			if (t.align == CENTER) {
+				x -= w / 2.0f;
+				y -= h / 2.0f;
+			}
+			batch.draw(tex, SDL_FRect { x, y, w, h });
+		}
+		break;
+	}
+	default:
+		assert(false); // layers are not nested
+		break;
+	}
+}
@@ -0,0 +1,203 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Font;
+class LayerCache;
+class SpriteBatch;
+class TextRenderer;
+class Texture;
+
+/*
+ * The rendering of one frame, recorded as a list of plain commands (clear,
+ * sprite, text) instead of being done at once. Recording does not call SDL
+ * at all -- textures and fonts are referred to by pointer, and the
+ * characters of texts are copied to a pool owned by the list -- so a frame
+ * can be recorded in one thread and rendered in another, the one that owns
+ * the renderer (see RenderQueue).
+ *
+ * Each command has a 64-bit sort key:
+ *
+ *   bits 63..56  layer, set with setLayer(), layers are drawn in order
+ *   bits 55..40  texture (the SDL texture, so views of an atlas are one;
+ *                for texts, the font)
+ *   bits 39..0   zero
+ *
+ * submit() radix-sorts the commands by key and renders them through a
+ * SpriteBatch and a TextRenderer, flushing the batch between layers. So
+ * the order of the layers is explicit, and within a layer all the sprites
+ * of a texture are contiguous (the fewest texture switches). The sort is
+ * stable, so commands with the same key keep the order in which they were
+ * recorded -- the depth within a texture is the recording order. The blend
+ * mode is a property of the SDL texture, so the texture already groups it.
+ * Clearing comes always first.
+ *
+ * What is recorded between beginCached() and endCached() is a cached layer:
+ * it is rendered to a texture of a LayerCache only when its version
+ * changes, and that texture is what is drawn in every frame (one sprite).
+ * Recording it is cheap, the saving is in not rendering it.
+ *
+ * Sprites of textures that are not loaded when the list is rendered (see
+ * ResourceCache) are skipped.
+ *
+ * The vectors are kept when the list is reset, so once they have grown
+ * recording a frame allocates nothing.
+ */
+class RenderList {
+public:
+
+	// How the (x,y) of a text is interpreted
+	enum Align : std::uint8_t {
+		TOP_LEFT, // top-left corner of the text
+		CENTER // center of the text
+	};
+
+	RenderList();
+	virtual ~RenderList();
+
+	// Removes all the commands, and goes back to layer 0.
+	//
+	void reset();
+
+	// The layer of the commands recorded from now on (0 is the bottom).
+	//
+	inline void setLayer(std::uint8_t layer) {
+		_layer = layer;
+	}
+
+	// Clears the renderer with 'color'.
+	//
+	void clear(SDL_Color color);
+
+	// Like SpriteBatch::draw.
+	//
+	void draw(const Texture &tex, const SDL_FRect &src, const SDL_FRect &dest,
+			float angle = 0.0f, SDL_FColor color = { 1.0f, 1.0f, 1.0f, 1.0f });
+
+	// The whole texture, with the size it has when the list is rendered.
+	//
+	void draw(const Texture &tex, const SDL_FRect &dest, float angle = 0.0f);
+
+	// Text drawn from the glyph atlas of the font, for text that changes --
+	// like TextRenderer::draw.
+	//
+	void text(const Font &font, const std::string &text, float x, float y,
+			SDL_Color color, Align align = TOP_LEFT);
+
+	// Text drawn with its own texture, created only the first time it is
+	// drawn, for text that does not change -- like TextRenderer::cached.
+	//
+	void cachedText(const Font &font, const std::string &text, float x,
+			float y, SDL_Color color, Align align = TOP_LEFT);
+
+	// What is recorded from beginCached() to endCached() (sprites and texts,
+	// in the order in which they are recorded) is layer 'id' of the
+	// LayerCache, and is only rendered when 'version' is not the one it was
+	// rendered with. 'version' must change whenever what is recorded
+	// changes. The layer is drawn below the rest of the current layer.
+	//
+	void beginCached(std::uint32_t id, std::uint64_t version);
+	void endCached();
+
+	// Renders the commands in the order of their keys. The batch is
+	// flushed at the end.
+	//
+	void submit(SDL_Renderer *renderer, SpriteBatch &batch,
+			TextRenderer &text, LayerCache &layers);
+
+	inline std::size_t size() const {
+		return _cmds.size();
+	}
+
+private:
+	enum Type : std::uint8_t {
+		CLEAR, SPRITE, TEXT, CACHED_TEXT, CACHED
+	};
+
+	static constexpr std::uint32_t NOT_CACHED = 0xffffffff;
+
+	static constexpr int LAYER_SHIFT = 56;
+	static constexpr int TEXTURE_SHIFT = 40;
+	static constexpr std::size_t MAX_TEXTURES = 0xffff; // 16 bits, with 0
+
+	struct Sprite {
+		const Texture *tex;
+		SDL_FRect src;
+		SDL_FRect dest;
+		float angle;
+		SDL_FColor color;
+	};
+
+	struct Text {
+		const Font *font;
+		std::uint32_t begin; // in _chars
+		std::uint32_t length;
+		float x;
+		float y;
+		SDL_Color color;
+		Align align;
+	};
+
+	struct Cached {
+		std::uint32_t id; // in the LayerCache
+		std::uint32_t begin; // in _nested
+		std::uint32_t count;
+		std::uint64_t version;
+	};
+
+	struct Command {
+		Type type;
+		std::uint64_t key;
+		union {
+			Sprite sprite;
+			Text text;
+			SDL_Color clear;
+			Cached cached;
+		};
+	};
+
+	void record(const Command &c);
+
+	void addText(Type type, const Font &font, const std::string &text,
+			float x, float y, SDL_Color color, Align align);
+
+	// key of a command of the current layer that uses 'tex' (any pointer
+	// that identifies the texture)
+	std::uint64_t key(const void *tex);
+
+	// sorts the commands by key into _order
+	void sort();
+
+	void submit(const Command &c, SDL_Renderer *renderer, SpriteBatch &batch,
+			TextRenderer &text);
+	void submitCached(const Cached &k, SDL_Renderer *renderer,
+			SpriteBatch &batch, TextRenderer &text, LayerCache &layers);
+
+	std::vector<Command> _cmds;
+	std::vector<Command> _nested; // of the cached layers
+	std::uint32_t _cachedBegin; // NOT_CACHED, or the first in _nested
+	std::uint32_t _cachedId;
+	std::uint64_t _cachedVersion;
+	std::vector<char> _chars; // the characters of all the texts
+	std::uint8_t _layer;
+
+	// textures of this frame, their index + 1 is the one in the keys (0 is
+	// for clearing). Emptied in every frame: textures are destroyed and
+	// created (see ResourceCache), and a key is only compared with those of
+	// the same frame.
+	std::vector<const void*> _textures;
+	std::size_t _lastTexture; // most commands repeat the previous texture
+
+	std::vector<std::uint64_t> _keys; // for sorting, reused
+	std::vector<std::uint32_t> _order;
+	std::vector<std::uint64_t> _tmpKeys;
+	std::vector<std::uint32_t> _tmpOrder;
+
+	std::string _str; // to pass a text to TextRenderer, reused
+};
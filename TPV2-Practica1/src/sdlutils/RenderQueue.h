@@ -0,0 +1,77 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <mutex>
+#include <utility>
+
+#include "RenderList.h"
+
+/*
+ * Hands the RenderList of each frame from the thread that records it to
+ * the thread that renders it, with three lists (triple buffering):
+ *
+ * - recording(): the one being recorded, only touched by the recording
+ *   thread,
+ * - the last complete one, waiting to be rendered,
+ * - acquire(): the one being rendered, only touched by the rendering
+ *   thread.
+ *
+ * publish() and acquire() just swap two of them under a lock, so neither
+ * thread ever waits for the other to finish a frame. If two frames are
+ * published before one is acquired, the older one is dropped.
+ */
+class RenderQueue {
+public:
+
+	RenderQueue() :
+			_write(0), //
+			_ready(1), //
+			_read(2), //
+			_fresh(false) {
+	}
+
+	virtual ~RenderQueue() {
+	}
+
+	RenderQueue(const RenderQueue&) = delete;
+	RenderQueue& operator=(const RenderQueue&) = delete;
+
+	// The list where the current frame is recorded.
+	//
+	inline RenderList& recording() {
+		return _lists[_write];
+	}
+
+	// The recorded frame is complete, it becomes the next to be rendered and
+	// recording starts on an empty list.
+	//
+	inline void publish() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			std::swap(_write, _ready);
+			_fresh = true;
+		}
+		_lists[_write].reset();
+	}
+
+	// The last frame published, or nullptr if none has been published since
+	// the previous call. It can be used until the next call.
+	//
+	inline RenderList* acquire() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!_fresh)
+			return nullptr;
+		std::swap(_read, _ready);
+		_fresh = false;
+		return &_lists[_read];
+	}
+
+private:
+	RenderList _lists[3];
+	int _write;
+	int _ready;
+	int _read;
+	bool _fresh; // _ready has not been acquired yet
+	std::mutex _mutex;
+};
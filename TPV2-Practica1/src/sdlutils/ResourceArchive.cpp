@@ -0,0 +1,324 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "ResourceArchive.h"
+
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "../json/JSON.h"
+
+namespace {
+
+const char MAGIC[4] = { 'T', 'P', 'A', 'K' };
+const std::uint32_t VERSION = 2;
+const std::size_t ALIGN = 64;
+
+struct Header {
+	char magic[4];
+	std::uint32_t version;
+	std::uint32_t numEntries;
+	std::uint32_t namesSize; // bytes of the names, after the entries
+};
+
+struct Record {
+	std::uint32_t kind;
+	std::uint32_t format; // SDL_PixelFormat or SDL_AudioFormat
+	std::int32_t a; // width, or channels
+	std::int32_t b; // height, or frequency
+	std::int32_t pitch;
+	std::uint32_t name; // offset in the names
+	std::uint64_t offset; // of the data, from the start of the archive
+	std::uint64_t size;
+	std::uint64_t srcSize; // of the file it was built from
+	std::int64_t srcTime; // its modification time (SDL_Time)
+};
+
+inline std::size_t aligned(std::size_t n) {
+	return (n + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+// size and modification time of a file, false if it does not exist
+inline bool sourceInfo(const std::string &file, std::uint64_t &size,
+		std::int64_t &time) {
+	SDL_PathInfo info;
+	if (!SDL_GetPathInfo(file.c_str(), &info)
+			|| info.type != SDL_PATHTYPE_FILE)
+		return false;
+	size = info.size;
+	time = info.modify_time;
+	return true;
+}
+
+} // namespace
+
+ResourceArchive::ResourceArchive() :
+		_file(), //
+		_entries() {
+}
+
+ResourceArchive::~ResourceArchive() {
+}
+
+bool ResourceArchive::open(const std::string &fileName) {
+	close();
+	if (!_file.open(fileName))
+		return false;
+
+	const unsigned char *base = _file.data();
+	std::size_t size = _file.size();
+
+	Header h;
+	if (size < sizeof(Header))
+		throw "'" + fileName + "' is not a resource archive";
+	std::memcpy(&h, base, sizeof(Header));
+	if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0
+			|| h.version != VERSION)
+		throw "'" + fileName + "' is not a resource archive (or it is old)";
+
+	// nothing of what is read is trusted: no sum can overflow, and no
+	// entry can refer to anything outside the file
+	if (h.numEntries > (size - sizeof(Header)) / sizeof(Record))
+		throw "'" + fileName + "' is truncated";
+	std::size_t namesBegin = sizeof(Header) + h.numEntries * sizeof(Record);
+	if (h.namesSize > size - namesBegin)
+		throw "'" + fileName + "' is truncated";
+	const char *names = reinterpret_cast<const char*>(base + namesBegin);
+
+	bool stale = false;
+	_entries.reserve(h.numEntries);
+	for (std::uint32_t i = 0; i < h.numEntries; i++) {
+		Record r;
+		std::memcpy(&r, base + sizeof(Header) + i * sizeof(Record),
+				sizeof(Record));
+		if (r.offset > size || r.size > size - r.offset)
+			throw "'" + fileName + "' is truncated";
+		if (r.name >= h.namesSize
+				|| std::memchr(names + r.name, '\0', h.namesSize - r.name)
+						== nullptr)
+			throw "'" + fileName + "' has an invalid name";
+		if (r.kind > RAW)
+			throw "'" + fileName + "' has an entry of an unknown kind";
+
+		Entry e { };
+		e.kind = static_cast<Kind>(r.kind);
+		e.data = base + r.offset;
+		e.size = static_cast<std::size_t>(r.size);
+		if (e.kind == IMAGE) {
+			e.format = static_cast<SDL_PixelFormat>(r.format);
+			e.width = r.a;
+			e.height = r.b;
+			e.pitch = r.pitch;
+			if (e.width <= 0 || e.height <= 0
+					|| e.pitch < e.width * SDL_BYTESPERPIXEL(e.format)
+					|| static_cast<std::uint64_t>(e.pitch) * e.height > r.size)
+				throw "'" + fileName + "' has an invalid image";
+		} else if (e.kind == SOUND) {
+			e.spec.format = static_cast<SDL_AudioFormat>(r.format);
+			e.spec.channels = r.a;
+			e.spec.freq = r.b;
+			if (e.spec.channels <= 0 || e.spec.freq <= 0)
+				throw "'" + fileName + "' has an invalid sound";
+		}
+
+		// the files that are not there (e.g., only the archive is
+		// distributed) are not checked
+		std::uint64_t srcSize;
+		std::int64_t srcTime;
+		if (sourceInfo(names + r.name, srcSize, srcTime)
+				&& (srcSize != r.srcSize || srcTime != r.srcTime))
+			stale = true;
+
+		_entries.emplace(names + r.name, e);
+	}
+
+	if (stale) {
+		std::cerr << "'" << fileName << "' is older than the files it was "
+				"built from, they are loaded instead (rebuild it with --pack)"
+				<< std::endl;
+		close();
+		return false;
+	}
+	return true;
+}
+
+void ResourceArchive::close() {
+	_entries.clear();
+	_file.close();
+}
+
+const ResourceArchive::Entry* ResourceArchive::find(
+		const std::string &fileName, Kind kind) const {
+	auto it = _entries.find(fileName);
+	if (it == _entries.end())
+		return nullptr;
+	if (it->second.kind != kind)
+		throw "'" + fileName + "' is not of the expected kind in the archive";
+	return &it->second;
+}
+
+// ---- Building ----
+
+namespace {
+
+struct Packed {
+	std::string name;
+	Record record;
+	std::vector<unsigned char> data;
+};
+
+void packImage(const std::string &file, Packed &p) {
+	SDL_Surface *s = IMG_Load(file.c_str());
+	if (s == nullptr)
+		throw "Couldn't load image '" + file + "': " + SDL_GetError();
+	SDL_Surface *c = SDL_ConvertSurface(s, SDL_PIXELFORMAT_ARGB8888);
+	SDL_DestroySurface(s);
+	if (c == nullptr)
+		throw "Couldn't convert image '" + file + "': " + SDL_GetError();
+
+	p.record.kind = ResourceArchive::IMAGE;
+	p.record.format = SDL_PIXELFORMAT_ARGB8888;
+	p.record.a = c->w;
+	p.record.b = c->h;
+	p.record.pitch = c->w * 4; // without the padding of the surface
+	p.data.resize(static_cast<std::size_t>(c->h) * p.record.pitch);
+	for (int y = 0; y < c->h; y++)
+		std::memcpy(&p.data[static_cast<std::size_t>(y) * p.record.pitch],
+				static_cast<unsigned char*>(c->pixels) + y * c->pitch,
+				p.record.pitch);
+	SDL_DestroySurface(c);
+}
+
+void packSound(const std::string &file, Packed &p) {
+	MIX_AudioDecoder *dec = MIX_CreateAudioDecoder(file.c_str(), 0);
+	if (dec == nullptr)
+		throw "Couldn't load sound '" + file + "': " + SDL_GetError();
+
+	// in its own format, the mixer converts it when playing
+	SDL_AudioSpec spec;
+	MIX_GetAudioDecoderFormat(dec, &spec);
+	unsigned char buf[64 * 1024];
+	int n;
+	while ((n = MIX_DecodeAudio(dec, buf, sizeof(buf), &spec)) > 0)
+		p.data.insert(p.data.end(), buf, buf + n);
+	MIX_DestroyAudioDecoder(dec);
+	if (n < 0)
+		throw "Couldn't decode sound '" + file + "': " + SDL_GetError();
+
+	p.record.kind = ResourceArchive::SOUND;
+	p.record.format = spec.format;
+	p.record.a = spec.channels;
+	p.record.b = spec.freq;
+}
+
+void packRaw(const std::string &file, Packed &p) {
+	std::ifstream in(file, std::ios::binary);
+	if (!in)
+		throw "Couldn't open '" + file + "'";
+	p.data.assign(std::istreambuf_iterator<char>(in),
+			std::istreambuf_iterator<char>());
+	p.record.kind = ResourceArchive::RAW;
+}
+
+} // namespace
+
+void ResourceArchive::build(const std::string &resourcesFile) {
+
+	std::unique_ptr<JSONValue> jValueRoot(JSON::ParseFromFile(resourcesFile));
+	if (jValueRoot == nullptr || !jValueRoot->IsObject())
+		throw "Something went wrong while load/parsing '" + resourcesFile
+				+ "'";
+	JSONObject root = jValueRoot->AsObject();
+	if (root["archive"] == nullptr)
+		throw "No 'archive' in '" + resourcesFile + "'";
+	std::string archiveFile = root["archive"]->AsString();
+
+	if (!MIX_Init())
+		throw "Couldn't initialize SDL_mixer: " + std::string(SDL_GetError());
+
+	// each file once (e.g., a font in several sizes)
+	std::vector<Packed> packed;
+	std::unordered_map<std::string, bool> seen;
+	auto pack = [&](const char *section, void (*f)(const std::string&,
+			Packed&)) {
+		JSONValue *jValue = root[section];
+		if (jValue == nullptr)
+			return;
+		if (!jValue->IsArray())
+			throw "'" + std::string(section) + "' is not an array in '"
+					+ resourcesFile + "'";
+		for (auto &v : jValue->AsArray()) {
+			if (!v->IsObject())
+				throw "'" + std::string(section) + "' array in '"
+						+ resourcesFile + "' includes and invalid value";
+			JSONObject vObj = v->AsObject();
+			std::string file = vObj["file"]->AsString();
+			if (seen[file])
+				continue;
+			seen[file] = true;
+			packed.push_back(Packed { file, Record { }, { } });
+			Record &r = packed.back().record;
+			if (!sourceInfo(file, r.srcSize, r.srcTime))
+				throw "Couldn't find '" + file + "'";
+			f(file, packed.back());
+#ifdef _DEBUG
+			std::cout << "Packed '" << file << "', " << packed.back().data.size()
+					<< " bytes" << std::endl;
+#endif
+		}
+	};
+	try {
+		pack("fonts", packRaw);
+		pack("images", packImage);
+		pack("sounds", packSound);
+	} catch (...) {
+		MIX_Quit();
+		throw;
+	}
+	MIX_Quit();
+
+	// the layout: header, records, names, and the data aligned
+	Header h;
+	std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+	h.version = VERSION;
+	h.numEntries = static_cast<std::uint32_t>(packed.size());
+	std::string names;
+	for (auto &p : packed) {
+		p.record.name = static_cast<std::uint32_t>(names.size());
+		names += p.name;
+		names += '\0';
+	}
+	h.namesSize = static_cast<std::uint32_t>(names.size());
+
+	std::size_t offset = aligned(
+			sizeof(Header) + packed.size() * sizeof(Record) + names.size());
+	for (auto &p : packed) {
+		p.record.offset = offset;
+		p.record.size = p.data.size();
+		offset = aligned(offset + p.data.size());
+	}
+
+	std::ofstream out(archiveFile, std::ios::binary | std::ios::trunc);
+	if (!out)
+		throw "Couldn't create '" + archiveFile + "'";
+	out.write(reinterpret_cast<const char*>(&h), sizeof(Header));
+	for (auto &p : packed)
+		out.write(reinterpret_cast<const char*>(&p.record), sizeof(Record));
+	out.write(names.data(), names.size());
+	for (auto &p : packed) {
+		std::size_t pad = static_cast<std::size_t>(p.record.offset)
+				- static_cast<std::size_t>(out.tellp());
+		out.write(std::string(pad, '\0').data(), pad);
+		out.write(reinterpret_cast<const char*>(p.data.data()), p.data.size());
+	}
+	if (!out)
+		throw "Couldn't write '" + archiveFile + "'";
+
+	std::cout << "Packed " << packed.size() << " files of '" << resourcesFile
+			<< "' in '" << archiveFile << "', " << out.tellp() << " bytes"
+			<< std::endl;
+}
@@ -0,0 +1,89 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "../utils/MappedFile.h"
+
+/*
+ * All the files of a resources file (see SDLUtils::loadReasources) packed
+ * into one, already decoded, so loading them is just mapping the archive
+ * to memory (see MappedFile) and handing pointers to SDL:
+ *
+ * - images, as pixels in ARGB8888 (the first texture format of most SDL
+ *   renderers, so creating the texture is a plain copy),
+ * - sounds, as PCM with its format,
+ * - any other file (fonts) as it is, for SDL to parse from memory with
+ *   SDL_IOFromConstMem.
+ *
+ * Files are found by the name they have in the resources file. The layout
+ * is a header, the entries, their names, and then the data of each entry
+ * aligned to 64 bytes. It is native-endian, an archive is built on the
+ * machine that uses it -- with build(), e.g., from the command line of the
+ * game (--pack).
+ */
+class ResourceArchive {
+public:
+
+	enum Kind : std::uint32_t {
+		IMAGE, SOUND, RAW
+	};
+
+	struct Entry {
+		Kind kind;
+		const void *data;
+		std::size_t size;
+
+		// IMAGE
+		SDL_PixelFormat format;
+		int width;
+		int height;
+		int pitch;
+
+		// SOUND
+		SDL_AudioSpec spec;
+	};
+
+	ResourceArchive();
+	virtual ~ResourceArchive();
+
+	ResourceArchive(const ResourceArchive&) = delete;
+	ResourceArchive& operator=(const ResourceArchive&) = delete;
+
+	// Maps the archive, false if it does not exist or if it is stale -- one
+	// of the files it was built from has changed since (a warning is
+	// written, and those files have to be loaded instead). Throws if it is
+	// not a valid archive.
+	//
+	bool open(const std::string &fileName);
+
+	// The data of the entries becomes invalid, so anything that uses it
+	// (fonts, sounds) must be destroyed before.
+	//
+	void close();
+
+	inline bool isOpen() const {
+		return _file.isOpen();
+	}
+
+	// The entry of a file, nullptr if it is not in the archive (or it is
+	// not open). Throws if it is, but not of that kind.
+	//
+	const Entry* find(const std::string &fileName, Kind kind) const;
+
+	// Packs the fonts, images and sounds of a resources file into the
+	// archive it names ("archive": "file"). It needs SDL_image and
+	// SDL_mixer (the decoders), not a window nor a renderer. Throws on
+	// error.
+	//
+	static void build(const std::string &resourcesFile);
+
+private:
+	MappedFile _file;
+	std::unordered_map<std::string, Entry> _entries;
+};
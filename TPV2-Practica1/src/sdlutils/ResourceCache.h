@@ -0,0 +1,293 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+ * A table of resources (textures, sounds) that are loaded the first time
+ * they are used, and unloaded, least recently used first, when the bytes
+ * of those loaded go over a budget.
+ *
+ * A resource is added with the function that loads it (add), or already
+ * loaded (emplace) -- those are never unloaded. The object of each key is
+ * always the same, so a reference to it is valid for the life of the
+ * table, but after unloading it is empty (T() moved into it) until it is
+ * loaded again. So what keeps a reference (e.g., a component that keeps a
+ * texture) must pin the resource while it uses it: pinned resources are
+ * loaded (if they are not) and not unloaded. at() only protects the
+ * resource during the current frame.
+ *
+ * Resources that can only be loaded from one thread (textures need the
+ * thread of the renderer) have an owner (setOwner): at() from other
+ * threads returns the object as it is, maybe empty, and leaves the loading
+ * to update(), that the owner calls between frames -- before rendering the
+ * frame that used it. Unloading is only done by update() and by loads in
+ * the owner thread, and never of what was used in the current frame, that
+ * might still be rendered.
+ *
+ * Every access takes a lock, so what is used often (e.g., a sound played in
+ * every frame, by the threads of many worlds) should be looked up once and
+ * the reference kept -- pinned, while the references are used.
+ */
+template<typename T>
+class ResourceCache {
+public:
+
+	// Loads a resource into an (empty) object, and returns its size in
+	// bytes. It can throw.
+	using Loader = std::function<std::size_t(T&)>;
+
+	struct Stats {
+		std::size_t hits; // at() of a loaded resource
+		std::size_t misses; // loads
+		std::size_t evictions; // unloads
+		Uint64 loadNS; // time spent loading
+		std::size_t bytes; // of the loaded resources
+		std::size_t peakBytes;
+		std::size_t resident; // number of loaded resources
+		std::size_t total;
+	};
+
+	ResourceCache(const std::string &desc) :
+			_desc(desc), //
+			_entries(), //
+			_queue(), //
+			_budget(0), //
+			_owner(), //
+			_frame(1), //
+			_tick(0), //
+			_stats(), //
+			_mtx() {
+	}
+
+	virtual ~ResourceCache() {
+	}
+
+	ResourceCache(const ResourceCache&) = delete;
+	ResourceCache& operator=(const ResourceCache&) = delete;
+
+	inline void reserve(std::size_t n) {
+		std::lock_guard<std::mutex> lock(_mtx);
+		_entries.reserve(n);
+	}
+
+	// Unloads everything and forgets the keys.
+	//
+	inline void clear() {
+		std::lock_guard<std::mutex> lock(_mtx);
+		_entries.clear();
+		_queue.clear();
+		_stats = Stats();
+	}
+
+	// Bytes of loaded resources to keep at most, 0 is no limit. What is
+	// pinned, always resident, or used in this frame can go over it.
+	//
+	inline void setBudget(std::size_t bytes) {
+		std::lock_guard<std::mutex> lock(_mtx);
+		_budget = bytes;
+	}
+
+	// The thread that loads, see above. By default any thread can.
+	//
+	inline void setOwner(std::thread::id owner) {
+		std::lock_guard<std::mutex> lock(_mtx);
+		_owner = owner;
+	}
+
+	// A resource that is loaded and is never unloaded.
+	//
+	inline void emplace(const std::string &key, T &&obj,
+			std::size_t bytes = 0) {
+		std::lock_guard<std::mutex> lock(_mtx);
+		Entry &e = _entries[key];
+		e.obj = std::move(obj);
+		e.resident = true;
+		e.bytes = bytes;
+		charge(bytes);
+		_stats.total = _entries.size();
+	}
+
+	// A resource that is loaded when it is first used.
+	//
+	inline void add(const std::string &key, Loader load) {
+		std::lock_guard<std::mutex> lock(_mtx);
+		Entry &e = _entries[key];
+		e.load = std::move(load);
+		_stats.total = _entries.size();
+	}
+
+	// The resource, loaded if it is not (or, in a thread that is not the
+	// owner, queued for update()).
+	//
+	inline const T& at(const std::string &key) {
+		std::lock_guard<std::mutex> lock(_mtx);
+		Entry &e = find(key);
+		touch(e);
+		if (e.resident)
+			_stats.hits++;
+		else
+			require(key, e);
+		return e.obj;
+	}
+
+	inline const T& operator[](const std::string &key) {
+		return at(key);
+	}
+
+	// The object of the resource, as it is (maybe not loaded), e.g., to
+	// keep a reference to a resource that will be pinned later.
+	//
+	inline const T& get(const std::string &key) {
+		std::lock_guard<std::mutex> lock(_mtx);
+		return find(key).obj;
+	}
+
+	// Pins/unpins the resource (they are counted, it is pinned while there
+	// are more pins than unpins). Pinning loads it, as at() does.
+	//
+	inline void pin(const std::string &key) {
+		std::lock_guard<std::mutex> lock(_mtx);
+		Entry &e = find(key);
+		e.pins++;
+		touch(e);
+		if (!e.resident)
+			require(key, e);
+	}
+
+	inline void unpin(const std::string &key) {
+		std::lock_guard<std::mutex> lock(_mtx);
+		Entry &e = find(key);
+		if (e.pins > 0)
+			e.pins--;
+		touch(e); // it might be in the frame being rendered
+	}
+
+	// Loads what other threads asked for, unloads what is over the budget,
+	// and starts a new frame. Only from the owner, between frames.
+	//
+	inline void update() {
+		std::lock_guard<std::mutex> lock(_mtx);
+		for (auto &key : _queue) {
+			Entry &e = _entries.at(key);
+			if (!e.resident)
+				loadNow(key, e);
+		}
+		_queue.clear();
+		trim();
+		_frame++;
+	}
+
+	inline Stats stats() const {
+		std::lock_guard<std::mutex> lock(_mtx);
+		return _stats;
+	}
+
+	// Writes the stats, in one line.
+	//
+	inline void dump(std::ostream &out) const {
+		Stats s = stats();
+		out << _desc << ": " << s.resident << "/" << s.total << " resident, "
+				<< s.bytes / 1024 << " KB (peak " << s.peakBytes / 1024
+				<< " KB), " << s.hits << " hits, " << s.misses << " misses, "
+				<< s.evictions << " evictions, " << s.loadNS / 1000000.0
+				<< " ms loading" << std::endl;
+	}
+
+private:
+	struct Entry {
+		T obj;
+		Loader load; // empty if it is always resident
+		bool resident = false;
+		bool queued = false;
+		std::size_t bytes = 0;
+		std::uint64_t lastUse = 0; // _tick of the last use, for the LRU
+		std::uint64_t lastFrame = 0; // _frame of the last use
+		int pins = 0;
+	};
+
+	inline Entry& find(const std::string &key) {
+		auto it = _entries.find(key);
+		if (it == _entries.end())
+			throw "Key '" + key + "' does not exists in '" + _desc + "'";
+		return it->second;
+	}
+
+	inline void touch(Entry &e) {
+		e.lastUse = ++_tick;
+		e.lastFrame = _frame;
+	}
+
+	inline void charge(std::size_t bytes) {
+		_stats.bytes += bytes;
+		_stats.resident++;
+		if (_stats.bytes > _stats.peakBytes)
+			_stats.peakBytes = _stats.bytes;
+	}
+
+	// loads it now if this thread can, otherwise queues it
+	inline void require(const std::string &key, Entry &e) {
+		if (_owner == std::thread::id() || _owner == std::this_thread::get_id()) {
+			loadNow(key, e);
+			trim();
+		} else if (!e.queued) {
+			e.queued = true;
+			_queue.push_back(key);
+		}
+	}
+
+	inline void loadNow(const std::string &key, Entry &e) {
+		if (!e.load)
+			throw "Resource '" + key + "' of '" + _desc + "' cannot be loaded";
+		Uint64 start = SDL_GetTicksNS();
+		e.bytes = e.load(e.obj);
+		_stats.loadNS += SDL_GetTicksNS() - start;
+		_stats.misses++;
+		e.resident = true;
+		e.queued = false;
+		charge(e.bytes);
+	}
+
+	// unloads the least recently used until the budget is met, if possible
+	inline void trim() {
+		while (_budget > 0 && _stats.bytes > _budget) {
+			Entry *lru = nullptr;
+			for (auto &kv : _entries) {
+				Entry &e = kv.second;
+				if (e.resident && e.load && e.pins == 0
+						&& e.lastFrame < _frame
+						&& (lru == nullptr || e.lastUse < lru->lastUse))
+					lru = &e;
+			}
+			if (lru == nullptr)
+				return;
+			lru->obj = T();
+			lru->resident = false;
+			_stats.bytes -= lru->bytes;
+			_stats.resident--;
+			_stats.evictions++;
+		}
+	}
+
+	std::string _desc;
+	std::unordered_map<std::string, Entry> _entries; // nodes do not move
+	std::vector<std::string> _queue; // to load in update()
+	std::size_t _budget;
+	std::thread::id _owner;
+	std::uint64_t _frame;
+	std::uint64_t _tick;
+	Stats _stats;
+	mutable std::mutex _mtx;
+};
@@ -0,0 +1,166 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "ResourceLoader.h"
+
+#include <SDL_image.h>
+#include <cassert>
+#include <chrono>
+
+ResourceLoader::ResourceLoader() :
+		ResourceLoader(
+				std::thread::hardware_concurrency() > 1 ?
+						std::thread::hardware_concurrency() - 1 : 1) {
+}
+
+ResourceLoader::ResourceLoader(std::size_t workers) :
+		_queue(nullptr), //
+		_workers(), //
+		_mtx(), //
+		_ready(), //
+		_jobs(), //
+		_done(), //
+		_quit(false), //
+		_polled(0) {
+	assert(workers > 0);
+	_queue = SDL_CreateAsyncIOQueue();
+	if (_queue == nullptr)
+		throw "Couldn't create an async I/O queue: " + std::string(SDL_GetError());
+	for (std::size_t i = 0; i < workers; i++)
+		_workers.emplace_back(&ResourceLoader::work, this);
+}
+
+ResourceLoader::~ResourceLoader() {
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		_quit = true;
+	}
+	SDL_SignalAsyncIOQueue(_queue); // wakes up the workers that are waiting
+	for (auto &w : _workers)
+		w.join();
+
+	// waits for the reads in flight
+	SDL_DestroyAsyncIOQueue(_queue);
+
+	// what was loaded but never polled
+	for (auto &j : _jobs) {
+		if (j.surface != nullptr)
+			SDL_DestroySurface(j.surface);
+		if (j.audio != SoundManager::audio_t())
+			SoundManager::Instance()->release_audio(j.audio);
+	}
+}
+
+void ResourceLoader::loadImage(const std::string &key,
+		const std::string &file) {
+	load(IMAGE, key, file);
+}
+
+void ResourceLoader::loadSound(const std::string &key,
+		const std::string &file) {
+	load(SOUND, key, file);
+}
+
+void ResourceLoader::load(Kind kind, const std::string &key,
+		const std::string &file) {
+	std::size_t i;
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		i = _jobs.size();
+		_jobs.push_back(Job { kind, key, file, false, { }, nullptr,
+				SoundManager::audio_t() });
+	}
+	// the index of the job travels with the read
+	if (!SDL_LoadFileAsync(file.c_str(), _queue, reinterpret_cast<void*>(i))) {
+		std::lock_guard<std::mutex> lock(_mtx);
+		_jobs[i].error = SDL_GetError();
+		_jobs[i].ready = true;
+		_done.push_back(i);
+	}
+}
+
+void ResourceLoader::work() {
+	for (;;) {
+		{
+			std::lock_guard<std::mutex> lock(_mtx);
+			if (_quit)
+				return;
+		}
+
+		// the timeout is only in case _quit is set (and the queue signaled)
+		// right before waiting
+		SDL_AsyncIOOutcome outcome;
+		if (!SDL_WaitAsyncIOResult(_queue, &outcome, 100))
+			continue;
+
+		std::size_t i = reinterpret_cast<std::size_t>(outcome.userdata);
+		Kind kind;
+		{
+			std::lock_guard<std::mutex> lock(_mtx);
+			kind = _jobs[i].kind;
+		}
+
+		// decode from memory, the buffer is ours
+		std::string error;
+		SDL_Surface *surface = nullptr;
+		SoundManager::audio_t audio = SoundManager::audio_t();
+		if (outcome.result != SDL_ASYNCIO_COMPLETE) {
+			error = SDL_GetError();
+		} else {
+			SDL_IOStream *io = SDL_IOFromConstMem(outcome.buffer,
+					static_cast<std::size_t>(outcome.bytes_transferred));
+			if (kind == IMAGE) {
+				surface = IMG_Load_IO(io, true);
+				if (surface == nullptr)
+					error = SDL_GetError();
+			} else {
+				audio = SoundManager::Instance()->load_audio(io);
+				if (audio == SoundManager::audio_t())
+					error = SDL_GetError();
+			}
+		}
+		SDL_free(outcome.buffer);
+
+		{
+			std::lock_guard<std::mutex> lock(_mtx);
+			Job &j = _jobs[i];
+			j.surface = surface;
+			j.audio = audio;
+			j.error = error;
+			j.ready = true;
+			_done.push_back(i);
+		}
+		_ready.notify_all();
+	}
+}
+
+void ResourceLoader::poll(std::vector<Result> &results, Sint32 timeoutMS) {
+	std::unique_lock<std::mutex> lock(_mtx);
+
+	auto some = [this]() {
+		return !_done.empty() || _polled == _jobs.size();
+	};
+	if (timeoutMS < 0)
+		_ready.wait(lock, some);
+	else if (timeoutMS > 0)
+		_ready.wait_for(lock, std::chrono::milliseconds(timeoutMS), some);
+
+	std::string error;
+	for (std::size_t i : _done) {
+		Job &j = _jobs[i];
+		assert(j.ready);
+		j.ready = false;
+		_polled++;
+		if (!j.error.empty()) {
+			if (error.empty())
+				error = "Couldn't load '" + j.file + "': " + j.error;
+			continue;
+		}
+		results.push_back(Result { j.kind, j.key, j.surface, j.audio });
+		j.surface = nullptr; // the caller owns them now
+		j.audio = SoundManager::audio_t();
+	}
+	_done.clear();
+
+	if (!error.empty())
+		throw error;
+}
@@ -0,0 +1,107 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <SDL.h>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SoundManager.h"
+
+/*
+ * Loads images and sounds in the background. The files are read with
+ * SDL's asynchronous I/O (SDL_LoadFileAsync), and decoded from memory by
+ * worker threads -- one per hardware thread but the calling one, so
+ * loading scales with the number of cores. What needs the renderer,
+ * creating the textures, is left to the thread that owns it: poll() hands
+ * it the decoded surfaces (and the sounds, which need nothing else).
+ *
+ * Sounds are pre-decoded (MIX_LoadAudio_IO is thread-safe), as
+ * SoundManager::load_audio does.
+ */
+class ResourceLoader {
+public:
+
+	enum Kind {
+		IMAGE, SOUND
+	};
+
+	// Something loaded, now owned by whoever polled it
+	struct Result {
+		Kind kind;
+		std::string key;
+		SDL_Surface *surface; // IMAGE
+		SoundManager::audio_t audio; // SOUND
+	};
+
+	// By default, one worker less than the hardware threads (at least one).
+	//
+	ResourceLoader();
+	ResourceLoader(std::size_t workers);
+	virtual ~ResourceLoader();
+
+	ResourceLoader(const ResourceLoader&) = delete;
+	ResourceLoader& operator=(const ResourceLoader&) = delete;
+
+	// Starts loading an image/sound from 'file', that will be 'key' in the
+	// result. Only from the thread that polls.
+	//
+	void loadImage(const std::string &key, const std::string &file);
+	void loadSound(const std::string &key, const std::string &file);
+
+	// Adds to 'results' what has been loaded since the previous call,
+	// waiting up to 'timeoutMS' milliseconds (-1 forever) for something if
+	// there is nothing yet and not everything is done. Throws if a file
+	// could not be read or decoded.
+	//
+	void poll(std::vector<Result> &results, Sint32 timeoutMS = 0);
+
+	// Number of files to load, and number already polled.
+	//
+	inline std::size_t numFiles() const {
+		return _jobs.size();
+	}
+
+	inline std::size_t numPolled() const {
+		return _polled;
+	}
+
+	inline bool done() const {
+		return _polled == _jobs.size();
+	}
+
+	inline std::size_t numWorkers() const {
+		return _workers.size();
+	}
+
+private:
+	struct Job {
+		Kind kind;
+		std::string key;
+		std::string file;
+		bool ready; // decoded, not polled yet
+		std::string error; // empty if it went well
+		SDL_Surface *surface;
+		SoundManager::audio_t audio;
+	};
+
+	void load(Kind kind, const std::string &key, const std::string &file);
+	void work();
+
+	SDL_AsyncIOQueue *_queue;
+	std::vector<std::thread> _workers;
+
+	std::mutex _mtx;
+	std::condition_variable _ready;
+
+	// protected by _mtx (only the polling thread adds jobs)
+	std::vector<Job> _jobs;
+	std::vector<std::size_t> _done; // jobs ready, not polled yet
+	bool _quit;
+
+	std::size_t _polled; // only touched by the polling thread
+};
@@ -0,0 +1,81 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "RotationCache.h"
+
+#include <cassert>
+#include <cmath>
+
+RotationCache::RotationCache(SDL_Renderer *renderer, const Texture &tex,
+		int n) :
+		_renderer(renderer), //
+		_tex(&tex), //
+		_atlas(), //
+		_frames(), //
+		_step(360.0f / n), //
+		_cell(0) {
+	assert(renderer != nullptr && n > 0);
+
+	int w = tex.width(), h = tex.height();
+	_cell = static_cast<int>(std::ceil(std::sqrt(float(w * w + h * h))));
+	int cols = static_cast<int>(std::ceil(std::sqrt(float(n))));
+	int rows = (n + cols - 1) / cols;
+
+	_atlas = Texture(renderer, cols * _cell, rows * _cell);
+	// the frames are copied with their alpha (see below), not premultiplied
+	SDL_SetTextureBlendMode(_atlas.sdlTexture(), SDL_BLENDMODE_BLEND);
+
+	_frames.reserve(n);
+	for (int i = 0; i < n; i++)
+		_frames.emplace_back(_atlas,
+				SDL_Rect { (i % cols) * _cell, (i / cols) * _cell, _cell, _cell });
+
+	render();
+}
+
+void RotationCache::render() {
+	const Texture &tex = *_tex;
+	if (tex.sdlTexture() == nullptr)
+		return; // not loaded (see ResourceCache)
+
+	SDL_Texture *target = SDL_GetRenderTarget(_renderer);
+	SDL_SetRenderTarget(_renderer, _atlas.sdlTexture());
+	SDL_SetRenderDrawColor(_renderer, 0, 0, 0, 0);
+	SDL_RenderClear(_renderer);
+
+	// the pixels of the texture replace the transparent ones of the atlas
+	SDL_BlendMode mode;
+	SDL_GetTextureBlendMode(tex.sdlTexture(), &mode);
+	SDL_SetTextureBlendMode(tex.sdlTexture(), SDL_BLENDMODE_NONE);
+
+	int w = tex.width(), h = tex.height();
+	int cols = _atlas.width() / _cell;
+	for (int i = 0; i < numAngles(); i++) {
+		int x = (i % cols) * _cell;
+		int y = (i / cols) * _cell;
+		SDL_FRect dest { x + (_cell - w) / 2.0f, y + (_cell - h) / 2.0f,
+				static_cast<float>(w), static_cast<float>(h) };
+		tex.render(dest, i * _step);
+	}
+
+	SDL_SetTextureBlendMode(tex.sdlTexture(), mode);
+	SDL_SetRenderTarget(_renderer, target);
+}
+
+RotationCache::~RotationCache() {
+}
+
+const Texture& RotationCache::frame(float angle) const {
+	int n = numAngles();
+	int i = static_cast<int>(std::lround(angle / _step)) % n;
+	if (i < 0)
+		i += n;
+	return _frames[i];
+}
+
+SDL_FRect RotationCache::dest(const SDL_FRect &dest) const {
+	// the cell scaled as the texture is
+	float w = _cell * dest.w / _tex->width();
+	float h = _cell * dest.h / _tex->height();
+	return SDL_FRect { dest.x + (dest.w - w) / 2.0f, dest.y
+			+ (dest.h - h) / 2.0f, w, h };
+}
@@ -0,0 +1,65 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+#include "Texture.h"
+
+/*
+ * A texture pre-rendered at n angles (0, 360/n, 2*360/n, ... degrees),
+ * each one in a square cell of an atlas -- a cell is as big as the
+ * diagonal of the texture, so the rotated texture always fits.
+ *
+ * Drawing the nearest pre-rotated frame without rotation is the same as
+ * drawing the texture rotated, when the angle is a multiple of 360/n
+ * (e.g., the fighter turns in steps of 5 degrees, n = 72), and it is much
+ * cheaper for the software renderer: an axis-aligned quad is a plain
+ * blit, a rotated one is rasterized pixel by pixel. SpriteBatch uses it
+ * for the textures registered with SpriteBatch::setRotations.
+ *
+ * The frames are exact when the texture is drawn scaled by the same factor
+ * in both axes.
+ */
+class RotationCache {
+public:
+
+	RotationCache(SDL_Renderer *renderer, const Texture &tex, int n);
+	virtual ~RotationCache();
+
+	RotationCache(const RotationCache&) = delete;
+	RotationCache& operator=(const RotationCache&) = delete;
+
+	// the texture that is pre-rendered
+	inline const Texture& texture() const {
+		return *_tex;
+	}
+
+	inline int numAngles() const {
+		return static_cast<int>(_frames.size());
+	}
+
+	// the frame nearest to 'angle' (degrees, clockwise)
+	//
+	const Texture& frame(float angle) const;
+
+	// where to draw a frame so that it covers what the texture rotated
+	// around the center of 'dest' would
+	//
+	SDL_FRect dest(const SDL_FRect &dest) const;
+
+	// Renders the frames again, e.g., when the contents of the render
+	// targets have been lost (SDL_EVENT_RENDER_TARGETS_RESET). Nothing if the
+	// texture is not loaded.
+	//
+	void render();
+
+private:
+	SDL_Renderer *_renderer;
+	const Texture *_tex;
+	Texture _atlas;
+	std::vector<Texture> _frames; // views of _atlas
+	float _step; // degrees
+	int _cell; // side of a cell
+};
@@ -2,23 +2,53 @@
 
 #include "SDLUtils.h"
 
-#include <SDL_image.h>
-
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <memory>
+#include <thread>
 
 #include "../json/JSON.h"
+#include "../utils/SkylinePacker.h"
+#include "ResourceLoader.h"
+
+// what startLoading() leaves for updateLoading()
+struct SDLUtils::Loading {
+	std::unique_ptr<ResourceLoader> loader; // only if there are files to read
+	std::unique_ptr<JSONValue> json; // the animations are loaded at the end
+	std::string filename;
+	int atlasSize;
+	int atlasPadding;
+	bool lazy; // images and sounds loaded when used, see ResourceCache
+	std::vector<std::pair<std::string, SDL_Surface*>> toPack;
+	std::vector<std::pair<std::string, int>> toRotate;
+	std::vector<ResourceLoader::Result> results; // of a poll, reused
+	Uint64 start;
+
+	~Loading() {
+		for (auto &img : toPack)
+			SDL_DestroySurface(img.second);
+	}
+};
+
+// what a texture takes in video memory, more or less
+static std::size_t textureBytes(const Texture &tex) {
+	return static_cast<std::size_t>(tex.width()) * tex.height() * 4;
+}
 
 SDLUtils::SDLUtils() :
+		_headless(false), //
 		_windowTitle("SDL2 Demo"), //
 		_width(600), //
 		_height(480), //
 		_window(nullptr), //
 		_renderer(nullptr), //
+		_images("Images Table"), //
+		_sounds("Sounds Table"), //
 		_fontsAccessWrapper(_fonts, "Fonts Table"), //
-		_imagesAccessWrapper(_images, "Images Table"), //
 		_msgsAccessWrapper(_msgs, "Messages Table"), //
-		_soundsAccessWrapper(_sounds, "Sounds Table"), //
+		_animsAccessWrapper(_anims, "Animations Table"), //
+		_loading(), //
 		_currTime(currRealTime()), //
 		_deltaTime(0) //
 {
@@ -41,10 +71,13 @@ bool SDLUtils::init(const std::string& windowTitle, int width, int height) {
 }
 
 bool SDLUtils::init(const std::string& windowTitle, int width, int height,
-		const std::string& filename) {
+		const std::string& filename, bool headless) {
+	_headless = headless;
 	init(windowTitle, width, height);
 
-	loadReasources(filename);
+	// with no file, the resources can be loaded later (see startLoading)
+	if (!filename.empty())
+		loadReasources(filename);
 
 	// we always return true, because this class either exit or throws an
 	// exception on error. If you want to avoid using exceptions you should
@@ -64,6 +97,15 @@ void SDLUtils::initWindow() {
 #endif
 
 	// Initialize SDL
+	if (_headless) {
+		// only events, so the keyboard state is available (all keys up)
+		if (!SDL_Init(SDL_INIT_EVENTS)) {
+			std::cerr << SDL_GetError() << std::endl;
+			assert(false);
+		}
+		return;
+	}
+
 	if (!SDL_Init(
 	SDL_INIT_AUDIO | SDL_INIT_VIDEO | SDL_INIT_JOYSTICK | SDL_INIT_EVENTS)) {
 		std::cerr << SDL_GetError() << std::endl;
@@ -86,6 +128,8 @@ void SDLUtils::initWindow() {
 		std::cerr << SDL_GetError() << std::endl;
 		assert(false);
 	}
+	_text.setRenderer(_renderer);
+	_layers.setRenderer(_renderer, _width, _height);
 
 // hide cursor by default
 	hideCursor();
@@ -95,14 +139,20 @@ void SDLUtils::initWindow() {
 void SDLUtils::closeWindow() {
 
 // destroy renderer and window
-	SDL_DestroyRenderer(_renderer);
-	SDL_DestroyWindow(_window);
+	if (_renderer != nullptr)
+		SDL_DestroyRenderer(_renderer);
+	if (_window != nullptr)
+		SDL_DestroyWindow(_window);
 
 	SDL_Quit(); // quit SDL
 }
 
 void SDLUtils::initSDLExtensions() {
 
+	// no fonts or audio without a display
+	if (_headless)
+		return;
+
 #ifdef _DEBUG
 	std::cout << "Initializing SDL_ttf" << std::endl;
 #endif
@@ -125,14 +175,25 @@ void SDLUtils::initSDLExtensions() {
 }
 
 void SDLUtils::loadReasources(const std::string& filename) {
+	startLoading(filename);
+	while (!updateLoading(-1))
+		;
+}
+
+void SDLUtils::startLoading(const std::string& filename) {
+	assert(_loading == nullptr);
 // TODO check the correctness of values and issue a corresponding
 // exception. Now we just do some simple checks, and assume input
 // is correct.
 
-// Load JSON configuration file. We use a unique pointer since we
-// can exit the method in different ways, this way we guarantee that
-// it is always deleted
-	std::unique_ptr<JSONValue> jValueRoot(JSON::ParseFromFile(filename));
+// Load JSON configuration file. It is kept in _loading, that owns it,
+// until the loading finishes (the animations are loaded at the end)
+	_loading.reset(new Loading());
+	Loading &l = *_loading;
+	l.start = SDL_GetTicksNS();
+	l.filename = filename;
+	l.json.reset(JSON::ParseFromFile(filename));
+	JSONValue *jValueRoot = l.json.get();
 
 // check it was loaded correctly
 // the root must be a JSON object
@@ -147,9 +208,54 @@ void SDLUtils::loadReasources(const std::string& filename) {
 // TODO improve syntax error checks below, now we do not check
 //      validity of keys with values as sting or integer
 
-// load fonts
+// the files can come from an archive, with "archive": "file" (see
+// ResourceArchive), if it has been built -- the files that are not in it
+// are read and decoded by a ResourceLoader
+	jValue = root["archive"];
+	if (jValue != nullptr && !_headless) {
+		if (!_archive.open(jValue->AsString())) {
+#ifdef _DEBUG
+			std::cout << "No archive '" << jValue->AsString()
+					<< "', loading the files" << std::endl;
+#endif
+		}
+	}
+
+// the images and sounds can be loaded when they are first used, instead of
+// now, with "residency": { "vram": MB, "ram": MB } -- then the least
+// recently used are unloaded when the textures take more than 'vram' MB or
+// the sounds more than 'ram' MB (0, or missing, is no limit). See
+// ResourceCache. Images loaded this way are not packed into atlases.
+	l.lazy = false;
+	jValue = root["residency"];
+	if (jValue != nullptr && !_headless) {
+		if (jValue->IsObject()) {
+			JSONObject vObj = jValue->AsObject();
+			l.lazy = true;
+			if (vObj["vram"] != nullptr)
+				_images.setBudget(
+						static_cast<std::size_t>(vObj["vram"]->AsNumber()
+								* 1024 * 1024));
+			if (vObj["ram"] != nullptr)
+				_sounds.setBudget(
+						static_cast<std::size_t>(vObj["ram"]->AsNumber()
+								* 1024 * 1024));
+			// textures only in the thread of the renderer, this one
+			_images.setOwner(std::this_thread::get_id());
+		} else {
+			throw "'residency' is not an object in '" + filename + "'";
+		}
+	}
+
+	auto loader = [&l]() -> ResourceLoader& {
+		if (l.loader == nullptr)
+			l.loader.reset(new ResourceLoader());
+		return *l.loader;
+	};
+
+// load fonts (not in headless mode, SDL_ttf is not initialized)
 	jValue = root["fonts"];
-	if (jValue != nullptr) {
+	if (jValue != nullptr && !_headless) {
 		if (jValue->IsArray()) {
 			_fonts.reserve(jValue->AsArray().size()); // reserve enough space to avoid resizing
 			for (auto &v : jValue->AsArray()) {
@@ -161,7 +267,12 @@ void SDLUtils::loadReasources(const std::string& filename) {
 #ifdef _DEBUG
 					std::cout << "Loading font with id: " << key << std::endl;
 #endif
-					_fonts.emplace(key, Font(file, size));
+					auto *e = _archive.find(file, ResourceArchive::RAW);
+					if (e != nullptr)
+						_fonts.emplace(key,
+								Font(SDL_IOFromConstMem(e->data, e->size), size));
+					else
+						_fonts.emplace(key, Font(file, size));
 				} else {
 					throw "'fonts' array in '" + filename
 							+ "' includes and invalid value";
@@ -172,7 +283,26 @@ void SDLUtils::loadReasources(const std::string& filename) {
 		}
 	}
 
-// load images
+// the images can be packed into atlas textures, with "atlas": { "size":
+// N, "padding": P } -- each image becomes a view of a part of an atlas of
+// at most N x N pixels, with P pixels between images
+	l.atlasSize = 0;
+	l.atlasPadding = 2;
+	jValue = root["atlas"];
+	if (jValue != nullptr && !_headless && !l.lazy) {
+		if (jValue->IsObject()) {
+			JSONObject vObj = jValue->AsObject();
+			if (vObj["size"] != nullptr)
+				l.atlasSize = static_cast<int>(vObj["size"]->AsNumber());
+			if (vObj["padding"] != nullptr)
+				l.atlasPadding = static_cast<int>(vObj["padding"]->AsNumber());
+		} else {
+			throw "'atlas' is not an object in '" + filename + "'";
+		}
+	}
+
+// load images -- the files are read and decoded by the loader, and
+// become textures in updateLoading()
 	jValue = root["images"];
 	if (jValue != nullptr) {
 		if (jValue->IsArray()) {
@@ -185,7 +315,38 @@ void SDLUtils::loadReasources(const std::string& filename) {
 #ifdef _DEBUG
 					std::cout << "Loading image with id: " << key << std::endl;
 #endif
-					_images.emplace(key, Texture(renderer(), file));
+					// in headless mode there is no renderer to load it, an
+					// empty texture keeps the key valid
+					// the pixels of the archive are used as they are
+					auto *e = _archive.find(file, ResourceArchive::IMAGE);
+					if (_headless)
+						_images.emplace(key, Texture());
+					else if (l.lazy && e != nullptr)
+						_images.add(key, [this, e](Texture &tex) {
+							SDL_Surface *s = SDL_CreateSurfaceFrom(e->width,
+									e->height, e->format,
+									const_cast<void*>(e->data), e->pitch);
+							tex = Texture(renderer(), s);
+							SDL_DestroySurface(s);
+							return textureBytes(tex);
+						});
+					else if (l.lazy)
+						_images.add(key, [this, file](Texture &tex) {
+							tex = Texture(renderer(), file);
+							return textureBytes(tex);
+						});
+					else if (e != nullptr)
+						addImage(key,
+								SDL_CreateSurfaceFrom(e->width, e->height,
+										e->format, const_cast<void*>(e->data),
+										e->pitch));
+					else
+						loader().loadImage(key, file);
+					// it can be pre-rendered at N angles, with "rotations": N,
+					// for the software renderer (see RotationCache)
+					if (vObj["rotations"] != nullptr)
+						l.toRotate.emplace_back(key,
+								static_cast<int>(vObj["rotations"]->AsNumber()));
 				} else {
 					throw "'images' array in '" + filename
 							+ "' includes and invalid value";
@@ -196,9 +357,9 @@ void SDLUtils::loadReasources(const std::string& filename) {
 		}
 	}
 
-// load messages
+// load messages (not in headless mode, they need fonts)
 	jValue = root["messages"];
-	if (jValue != nullptr) {
+	if (jValue != nullptr && !_headless) {
 		if (jValue->IsArray()) {
 			_msgs.reserve(jValue->AsArray().size()); // reserve enough space to avoid resizing
 			for (auto &v : jValue->AsArray()) {
@@ -233,7 +394,7 @@ void SDLUtils::loadReasources(const std::string& filename) {
 		}
 	}
 
-// load sounds
+// load sounds, by the loader too
 	jValue = root["sounds"];
 	if (jValue != nullptr) {
 		if (jValue->IsArray()) {
@@ -247,7 +408,30 @@ void SDLUtils::loadReasources(const std::string& filename) {
 					std::cout << "Loading sound effect with id: " << key
 							<< std::endl;
 #endif
-					_sounds.emplace(key, SoundEffect(file));
+					// in headless mode an empty sound effect, it plays nothing
+					auto *e = _archive.find(file, ResourceArchive::SOUND);
+					if (_headless)
+						_sounds.emplace(key, SoundEffect());
+					else if (l.lazy && e != nullptr)
+						_sounds.add(key, [e](SoundEffect &sound) {
+							sound = SoundEffect(
+									SoundManager::Instance()->load_audio(e->data,
+											e->size, e->spec));
+							return e->size;
+						});
+					else if (l.lazy)
+						_sounds.add(key, [file](SoundEffect &sound) {
+							sound = SoundEffect(file);
+							return sound.size();
+						});
+					else if (e != nullptr)
+						_sounds.emplace(key,
+								SoundEffect(
+										SoundManager::Instance()->load_audio(
+												e->data, e->size, e->spec)),
+								e->size);
+					else
+						loader().loadSound(key, file);
 				} else {
 					throw "'sounds' array in '" + filename
 							+ "' includes and invalid value";
@@ -258,18 +442,225 @@ void SDLUtils::loadReasources(const std::string& filename) {
 		}
 	}
 
+	// nothing to wait for
+	if (l.loader == nullptr || l.loader->done())
+		finishLoading();
+}
+
+bool SDLUtils::updateLoading(Sint32 waitMS) {
+	if (_loading == nullptr)
+		return true;
+	Loading &l = *_loading;
+
+	// the textures are created here, in the thread of the renderer
+	l.results.clear();
+	l.loader->poll(l.results, waitMS);
+	for (auto &r : l.results) {
+		if (r.kind == ResourceLoader::SOUND)
+			_sounds.emplace(r.key, SoundEffect(r.audio),
+					SoundManager::Instance()->audio_size(r.audio));
+		else
+			addImage(r.key, r.surface);
+	}
+
+	if (!l.loader->done())
+		return false;
+	finishLoading();
+	return true;
+}
+
+void SDLUtils::addImage(const std::string &key, SDL_Surface *surface) {
+	assert(surface != nullptr);
+	if (_loading->atlasSize > 0) {
+		_loading->toPack.emplace_back(key, surface);
+	} else {
+		Texture tex(renderer(), surface);
+		std::size_t bytes = textureBytes(tex);
+		_images.emplace(key, std::move(tex), bytes);
+		SDL_DestroySurface(surface);
+	}
+}
+
+float SDLUtils::loadingProgress() const {
+	if (_loading == nullptr)
+		return 1.0f;
+	const ResourceLoader &loader = *_loading->loader;
+	return static_cast<float>(loader.numPolled()) / loader.numFiles();
+}
+
+void SDLUtils::finishLoading() {
+	Loading &l = *_loading;
+	const std::string &filename = l.filename;
+
+	if (!l.toPack.empty())
+		packImages(l.toPack, l.atlasSize, l.atlasPadding);
+	if (!l.toRotate.empty() && !_headless)
+		buildRotations(l.toRotate);
+
+	JSONObject root = l.json->AsObject();
+	JSONValue *jValue = nullptr;
+
+// load animation clips, they refer to images so they go after them
+	jValue = root["animations"];
+	if (jValue != nullptr) {
+		if (jValue->IsArray()) {
+			_anims.reserve(jValue->AsArray().size()); // reserve enough space to avoid resizing
+			for (auto &v : jValue->AsArray()) {
+				if (v->IsObject()) {
+					JSONObject vObj = v->AsObject();
+					std::string key = vObj["id"]->AsString();
+					// not loaded if it is not, who uses the clip pins it
+					auto &tex = _images.get(vObj["image"]->AsString());
+					int cols = static_cast<int>(vObj["cols"]->AsNumber());
+					int rows = static_cast<int>(vObj["rows"]->AsNumber());
+					// 'frames' is optional, by default the whole grid
+					int frames =
+							vObj["frames"] != nullptr ?
+									static_cast<int>(vObj["frames"]->AsNumber()) :
+									cols * rows;
+#ifdef _DEBUG
+					std::cout << "Loading animation with id: " << key
+							<< std::endl;
+#endif
+					_anims.emplace(key,
+							AnimationClip(tex, cols, frames,
+									static_cast<float>(vObj["step_x"]->AsNumber()),
+									static_cast<float>(vObj["step_y"]->AsNumber()),
+									static_cast<float>(vObj["width"]->AsNumber()),
+									static_cast<float>(vObj["height"]->AsNumber()),
+									static_cast<float>(vObj["fps"]->AsNumber())));
+				} else {
+					throw "'animations' array in '" + filename
+							+ "' includes and invalid value";
+				}
+			}
+		} else {
+			throw "'animations' is not an array in '" + filename + "'";
+		}
+	}
+
+#ifdef _DEBUG
+	std::cout << "Loaded '" << filename << "' in "
+			<< (SDL_GetTicksNS() - l.start) / 1000000.0 << " ms";
+	if (l.loader != nullptr)
+		std::cout << " (" << l.loader->numWorkers() << " worker threads)";
+	std::cout << std::endl;
+#endif
+
+	_loading.reset();
 }
 
 void SDLUtils::closeSDLExtensions() {
 
+	_loading.reset(); // if it did not finish, before SoundManager
+
+	_text.clear(); // before the fonts
+	_layers.clear();
+	_anims.clear();
 	_sounds.clear();
 	_msgs.clear();
+	for (auto &r : _rotations)
+		_batch.setRotations(r->texture(), nullptr);
+	_rotations.clear(); // before the images
 	_images.clear();
+	_atlases.clear(); // after the views
 	_fonts.clear();
 
 	if (SoundManager::HasInstance())
 		SoundManager::Release();
+	_archive.close(); // after the fonts and sounds, they use its memory
 
-	TTF_Quit(); // quit SDL_ttf
+	if (!_headless)
+		TTF_Quit(); // quit SDL_ttf
 }
 
+void SDLUtils::packImages(
+		std::vector<std::pair<std::string, SDL_Surface*>> &images, int size,
+		int padding) {
+
+	// tallest first, the skyline packs them better
+	std::sort(images.begin(), images.end(), [](const auto &a, const auto &b) {
+		return a.second->h > b.second->h;
+	});
+
+	struct Page {
+		SkylinePacker packer;
+		std::vector<std::pair<std::size_t, SDL_Rect>> placed; // image, region
+	};
+	std::vector<Page> pages;
+
+	for (std::size_t i = 0; i < images.size(); i++) {
+		SDL_Surface *s = images[i].second;
+
+		// too big for an atlas, a texture of its own
+		if (s->w + padding > size || s->h + padding > size) {
+			_images.emplace(images[i].first, Texture(renderer(), s),
+					static_cast<std::size_t>(s->w) * s->h * 4);
+			continue;
+		}
+
+		// the first page where it fits, or a new one
+		int x = 0, y = 0;
+		std::size_t p = 0;
+		while (p < pages.size()
+				&& !pages[p].packer.insert(s->w + padding, s->h + padding, x, y))
+			p++;
+		if (p == pages.size()) {
+			pages.push_back(Page { SkylinePacker(size, size), { } });
+			pages[p].packer.insert(s->w + padding, s->h + padding, x, y);
+		}
+		pages[p].placed.emplace_back(i, SDL_Rect { x, y, s->w, s->h });
+	}
+
+	// copy the images to one surface per page, that becomes the atlas
+	_atlases.reserve(_atlases.size() + pages.size());
+	for (auto &page : pages) {
+		SDL_Surface *atlas = SDL_CreateSurface(page.packer.usedWidth(),
+				page.packer.usedHeight(), SDL_PIXELFORMAT_RGBA32);
+		assert(atlas != nullptr);
+		for (auto &pl : page.placed) {
+			SDL_Surface *s = images[pl.first].second;
+			SDL_SetSurfaceBlendMode(s, SDL_BLENDMODE_NONE); // copy the alpha too
+			SDL_BlitSurface(s, nullptr, atlas, &pl.second);
+		}
+		_atlases.emplace_back(renderer(), atlas);
+		SDL_DestroySurface(atlas);
+
+#ifdef _DEBUG
+		std::cout << "Packed " << page.placed.size() << " images in an atlas of "
+				<< page.packer.usedWidth() << "x" << page.packer.usedHeight()
+				<< std::endl;
+#endif
+
+		for (auto &pl : page.placed)
+			_images.emplace(images[pl.first].first,
+					Texture(_atlases.back(), pl.second),
+					static_cast<std::size_t>(pl.second.w) * pl.second.h * 4);
+	}
+
+	for (auto &img : images)
+		SDL_DestroySurface(img.second);
+	images.clear();
+}
+
+void SDLUtils::buildRotations(
+		const std::vector<std::pair<std::string, int>> &images) {
+
+	// other renderers rotate for free (and filter better)
+	const char *name = SDL_GetRendererName(renderer());
+	if (name == nullptr || std::strcmp(name, SDL_SOFTWARE_RENDERER) != 0)
+		return;
+
+	for (auto &img : images) {
+		if (img.second <= 0)
+			throw "Invalid number of rotations for image '" + img.first + "'";
+		const Texture &tex = _images.at(img.first);
+		_rotations.push_back(
+				std::make_unique<RotationCache>(renderer(), tex, img.second));
+		_batch.setRotations(tex, _rotations.back().get());
+#ifdef _DEBUG
+		std::cout << "Pre-rendered image " << img.first << " at " << img.second
+				<< " angles" << std::endl;
+#endif
+	}
+}
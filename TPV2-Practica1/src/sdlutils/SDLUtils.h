@@ -3,13 +3,24 @@
 #pragma once
 
 #include <SDL.h>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../utils/Singleton.h"
+#include "AnimationClip.h"
 #include "RandomNumberGenerator.h"
+#include "RenderQueue.h"
+#include "ResourceArchive.h"
+#include "ResourceCache.h"
+#include "RotationCache.h"
 #include "Font.h"
+#include "LayerCache.h"
 #include "SoundEffect.h"
+#include "SpriteBatch.h"
+#include "TextRenderer.h"
 #include "Texture.h"
 #include "VirtualTimer.h"
 
@@ -72,6 +83,27 @@ public:
 	SDLUtils& operator=(SDLUtils&) = delete;
 	SDLUtils& operator=(SDLUtils&&) = delete;
 
+	// true when initialized without window, renderer and audio (see init).
+	// In this mode the images are empty textures (nothing can be rendered),
+	// the sound effects do nothing, and there are no fonts or messages.
+	inline bool headless() const {
+		return _headless;
+	}
+
+	// Loads the resources of a JSON file in the background: the images and
+	// sounds are read and decoded by other threads (see ResourceLoader),
+	// fonts and messages right away. Then updateLoading() must be called
+	// from this thread, the one of the renderer, until it returns true --
+	// e.g., once per frame of a progress screen, where loadingProgress()
+	// (from 0 to 1) can be shown. It waits up to 'waitMS' milliseconds (-1
+	// forever) for something to be loaded. init() with a file does all this
+	// and waits, init() with an empty file name loads nothing. With
+	// "residency" in the file, the images and sounds are not loaded now but
+	// when they are first used (see images()).
+	void startLoading(const std::string &filename);
+	bool updateLoading(Sint32 waitMS = 0);
+	float loadingProgress() const;
+
 	// access to the underlying SDL_Window -- in principle not needed
 	inline SDL_Window* window() {
 		return _window;
@@ -85,12 +117,26 @@ public:
 
 	// clear the renderer with a given SDL_Color
 	inline void clearRenderer(SDL_Color bg = build_sdlcolor(0x00AAAAFF)) {
+		if (_headless)
+			return;
 	    SDL_SetRenderDrawColor(_renderer, COLOREXP(bg));
 		SDL_RenderClear(_renderer);
 	}
 
 	// present the current content of the renderer
 	inline void presentRenderer() {
+		if (_headless)
+			return;
+		_batch.flush();
+		SDL_RenderPresent(_renderer);
+	}
+
+	// render a frame recorded in a RenderList (maybe by another thread) and
+	// present it
+	inline void presentCommands(RenderList &cmds) {
+		if (_headless)
+			return;
+		cmds.submit(_renderer, _batch, _text, _layers);
 		SDL_RenderPresent(_renderer);
 	}
 
@@ -132,9 +178,10 @@ public:
 		return _fontsAccessWrapper;
 	}
 
-	// images map
+	// images map. With "residency" in the resources file they are loaded
+	// when first used, and unloaded when over budget (see ResourceCache)
 	inline auto& images() {
-		return _imagesAccessWrapper;
+		return _images;
 	}
 
 	// messages map
@@ -142,9 +189,28 @@ public:
 		return _msgsAccessWrapper;
 	}
 
-	// sound effects map
+	// sound effects map, like the images map
 	inline auto& soundEffects() {
-		return _soundsAccessWrapper;
+		return _sounds;
+	}
+
+	// Loads the images that other threads asked for, and unloads what is
+	// over the budgets. Must be called from this thread, between frames,
+	// when nothing uses the images (see ResourceCache::update).
+	inline void updateResidency() {
+		_images.update();
+		_sounds.update();
+	}
+
+	// writes the counters of the images and sounds maps
+	inline void dumpResidency(std::ostream &out) const {
+		_images.dump(out);
+		_sounds.dump(out);
+	}
+
+	// animation clips map, the clips refer to textures of the images map
+	inline auto& animations() {
+		return _animsAccessWrapper;
 	}
 
 	// Access to the random number generator. It is important to always
@@ -154,6 +220,46 @@ public:
 		return _random;
 	}
 
+	// Access to the sprite batch -- sprites drawn through it are rendered
+	// with one call per texture (see SpriteBatch.h). It is flushed by
+	// presentRenderer().
+	inline SpriteBatch& spriteBatch() {
+		return _batch;
+	}
+
+	// Access to the render queue -- frames are recorded as lists of
+	// commands, without calling SDL, and rendered later with
+	// presentCommands() (see RenderQueue.h)
+	inline RenderQueue& renderQueue() {
+		return _queue;
+	}
+
+	// the list where the current frame is being recorded
+	inline RenderList& commands() {
+		return _queue.recording();
+	}
+
+	// Access to the text renderer -- text drawn from a glyph atlas, or
+	// textures of strings created only once (see TextRenderer.h)
+	inline TextRenderer& text() {
+		return _text;
+	}
+
+	// Access to the render targets of the cached layers (see
+	// RenderList::beginCached)
+	inline LayerCache& layerCache() {
+		return _layers;
+	}
+
+	// The contents of the render targets have been lost (see
+	// InputHandler::renderTargetsResetEvent): the cached layers and the
+	// pre-rotated images are rendered again.
+	inline void renderTargetsReset() {
+		_layers.invalidate();
+		for (auto &r : _rotations)
+			r->render();
+	}
+
 	// Access to the virtual timer, it is useful when you allow to 'pause'
 	// your game, also for synchronising clocks of players (when using sdlnet)
 	inline VirtualTimer& virtualTimer() {
@@ -200,15 +306,33 @@ private:
 
 	SDLUtils();
 	bool init(const std::string& windowTitle, int width, int height);
+	// with headless=true there is no window, renderer or audio, and
+	// (width,height) are just the dimensions of the world
 	bool init(const std::string& windowTitle, int width, int height,
-			const std::string& filename);
+			const std::string& filename, bool headless = false);
 
 	void initWindow();
 	void closeWindow();
 	void initSDLExtensions(); // initialize resources (fonts, textures, audio, etc.)
 	void closeSDLExtensions(); // free resources the
-	void loadReasources(const std::string& filename); // load resources from the json file
+	void loadReasources(const std::string& filename); // load resources from the json file, waiting
+
+	// packs the images into atlas textures of (at most) size x size, and
+	// adds views of them to _images; the surfaces are destroyed
+	void packImages(std::vector<std::pair<std::string, SDL_Surface*>> &images,
+			int size, int padding);
+
+	// the part of the loading that needs all the images
+	void finishLoading();
 
+	// an image decoded while loading, goes to an atlas or becomes a texture
+	void addImage(const std::string &key, SDL_Surface *surface);
+
+	// pre-renders each image at n angles, (image, n), when the renderer is
+	// the software one
+	void buildRotations(const std::vector<std::pair<std::string, int>> &images);
+
+	bool _headless; // no window, renderer or audio
 	std::string _windowTitle; // window title
 	int _width; // window width
 	int _height; // window height
@@ -218,18 +342,28 @@ private:
 
 	// the 'const' in the following declarations is used
 	// to forbid moving the objects
+	ResourceArchive _archive; // if the resources file has one
 	sdl_resource_table<const Font> _fonts; // fonts map (string -> font)
-	sdl_resource_table<const Texture> _images; // textures map (string -> texture)
+	ResourceCache<Texture> _images; // textures map (string -> texture)
+	std::vector<Texture> _atlases; // atlas textures, _images are views of them
+	std::vector<std::unique_ptr<RotationCache>> _rotations; // of some _images
 	sdl_resource_table<const Texture> _msgs; // textures map (string -> texture)
-	sdl_resource_table<const SoundEffect> _sounds; // sounds map (string -> sound)
+	ResourceCache<SoundEffect> _sounds; // sounds map (string -> sound)
+	sdl_resource_table<const AnimationClip> _anims; // clips map (string -> clip)
 
 	map_access_wrapper<const Font> _fontsAccessWrapper;
-	map_access_wrapper<const Texture> _imagesAccessWrapper;
 	map_access_wrapper<const Texture> _msgsAccessWrapper;
-	map_access_wrapper<const SoundEffect> _soundsAccessWrapper;
+	map_access_wrapper<const AnimationClip> _animsAccessWrapper;
 
 	RandomNumberGenerator _random; // (pseudo) random numbers generator
 	VirtualTimer _timer; // virtual timer
+	SpriteBatch _batch; // sprites rendered by texture
+	TextRenderer _text; // glyph atlases and cached strings
+	RenderQueue _queue; // recorded frames, see presentCommands()
+	LayerCache _layers; // render targets of the cached layers
+
+	struct Loading;
+	std::unique_ptr<Loading> _loading; // while loading, see startLoading()
 
 	Uint64 _currTime;
 	Uint64 _deltaTime;
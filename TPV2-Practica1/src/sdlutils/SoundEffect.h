@@ -34,6 +34,11 @@ public:
 		return *this;
 	}
 
+	// takes an audio already loaded (e.g., by a ResourceLoader)
+	explicit SoundEffect(SoundManager::audio_t audio) noexcept :
+			_audio(audio) {
+	}
+
 	SoundEffect(const std::string &fileName) {
 		_audio = SoundManager::Instance()->load_audio(fileName.c_str());
 	}
@@ -42,20 +47,33 @@ public:
 		release();
 	}
 
-	// these methods just redirect to those of SoundManager
+	// these methods just redirect to those of SoundManager. An empty sound
+	// effect (e.g., when there is no audio) plays nothing.
 
 	inline bool play() const {
+		if (_audio == SoundManager::audio_t())
+			return false;
 		return SoundManager::Instance()->play(_audio);
 	}
 
 	inline bool play(const char *tag, int loops = 0) const {
+		if (_audio == SoundManager::audio_t())
+			return false;
 		return SoundManager::Instance()->play(_audio, tag, loops);
 	}
 
+	// bytes of its PCM, 0 if it is empty
+	inline std::size_t size() const {
+		if (_audio == SoundManager::audio_t())
+			return 0;
+		return SoundManager::Instance()->audio_size(_audio);
+	}
+
 private:
 
 	inline void release() {
-		SoundManager::Instance()->release_audio(_audio);
+		if (_audio != SoundManager::audio_t())
+			SoundManager::Instance()->release_audio(_audio);
 	}
 
 	SoundManager::audio_t _audio;
@@ -5,6 +5,7 @@
 #include <SDL_mixer.h>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <vector>
 
 #include "../utils/Singleton.h"
@@ -35,6 +36,32 @@ public:
 		return audio;
 	}
 
+	// load an audio from a stream (e.g., a file already read to memory),
+	// the stream is closed. Unlike load_audio, it can be called from any
+	// thread, and returns an empty audio if it fails
+	inline audio_t load_audio(SDL_IOStream *io) {
+		return MIX_LoadAudio_IO(_mixer, io, true, true);
+	}
+
+	// load PCM audio that is already in memory (e.g., in a ResourceArchive)
+	// without copying it -- the memory must outlive the audio
+	inline audio_t load_audio(const void *pcm, std::size_t size,
+			const SDL_AudioSpec &spec) {
+		audio_t audio = MIX_LoadRawAudioNoCopy(_mixer, pcm, size, &spec, false);
+		assert(audio != nullptr);
+		return audio;
+	}
+
+	// bytes of the PCM of an audio (loaded predecoded), 0 if it is not known
+	inline std::size_t audio_size(audio_t a) const {
+		SDL_AudioSpec spec;
+		Sint64 frames = MIX_GetAudioDuration(a);
+		if (frames <= 0 || !MIX_GetAudioFormat(a, &spec))
+			return 0;
+		return static_cast<std::size_t>(frames) * spec.channels
+				* SDL_AUDIO_BYTESIZE(spec.format);
+	}
+
 	// release an audio
 	inline void release_audio(audio_t a) {
 		MIX_DestroyAudio(a);
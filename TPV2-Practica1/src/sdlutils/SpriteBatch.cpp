@@ -0,0 +1,172 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "SpriteBatch.h"
+
+#include <cassert>
+#include <utility>
+
+#include "RotationCache.h"
+#include "Texture.h"
+#include "../utils/FastRotation.h"
+
+SpriteBatch::SpriteBatch() :
+		_buckets(), //
+		_used(), //
+		_last(0), //
+		_spare(), //
+		_indices(), //
+		_rotations(), //
+		_numSprites(0), //
+		_numDrawCalls(0) {
+}
+
+SpriteBatch::~SpriteBatch() {
+}
+
+SpriteBatch::Bucket& SpriteBatch::bucket(const Texture &tex) {
+	SDL_Texture *sdlTex = tex.sdlTexture();
+	if (_last < _buckets.size() && _buckets[_last].sdlTex == sdlTex)
+		return _buckets[_last];
+
+	// there are only a few textures, a linear search is enough
+	std::size_t i = 0;
+	while (i < _buckets.size() && _buckets[i].sdlTex != sdlTex)
+		i++;
+	if (i == _buckets.size()) {
+		_buckets.push_back(Bucket { sdlTex, &tex, { }, false });
+		if (!_spare.empty()) {
+			_buckets.back().vertices = std::move(_spare.back());
+			_spare.pop_back();
+		}
+	}
+
+	_last = i;
+	return _buckets[i];
+}
+
+void SpriteBatch::setRotations(const Texture &tex,
+		const RotationCache *rotations) {
+	for (auto it = _rotations.begin(); it != _rotations.end(); ++it)
+		if (it->first == &tex) {
+			_rotations.erase(it);
+			break;
+		}
+	if (rotations != nullptr)
+		_rotations.emplace_back(&tex, rotations);
+}
+
+const RotationCache* SpriteBatch::rotations(const Texture &tex) const {
+	for (auto &r : _rotations)
+		if (r.first == &tex)
+			return r.second;
+	return nullptr;
+}
+
+void SpriteBatch::draw(const Texture &tex, const SDL_FRect &src,
+		const SDL_FRect &dest, float angle, SDL_FColor color) {
+	if (angle != 0.0f && !_rotations.empty()) {
+		// the frames have the complete texture
+		const RotationCache *r = rotations(tex);
+		if (r != nullptr && src.x == 0.0f && src.y == 0.0f
+				&& src.w == tex.width() && src.h == tex.height()) {
+			const Texture &frame = r->frame(angle);
+			draw(frame,
+					SDL_FRect { 0.0f, 0.0f, static_cast<float>(frame.width()),
+							static_cast<float>(frame.height()) }, r->dest(dest),
+					0.0f, color);
+			return;
+		}
+	}
+
+	Bucket &b = bucket(tex);
+	if (b.vertices.empty())
+		_used.push_back(_last);
+	b.tex = &tex; // the one of the first draw might be gone already
+
+	// texture coordinates of src (in the atlas, if tex is a view)
+	SDL_FRect uv = tex.uv(src);
+	float u0 = uv.x, v0 = uv.y;
+	float u1 = uv.x + uv.w, v1 = uv.y + uv.h;
+
+	// corners relative to the center of dest, rotated clockwise on the
+	// screen (y grows downwards) as SDL_RenderTextureRotated does
+	float hw = dest.w * 0.5f, hh = dest.h * 0.5f;
+	float cx = dest.x + hw, cy = dest.y + hh;
+	float ax = hw, ay = 0.0f; // rotated (hw,0)
+	float bx = 0.0f, by = hh; // rotated (0,hh)
+	if (angle != 0.0f) {
+		SinCos sc = fastrot::steps5().get(angle);
+		ax = hw * sc.cos;
+		ay = hw * sc.sin;
+		bx = -hh * sc.sin;
+		by = hh * sc.cos;
+	}
+
+	b.vertices.push_back(
+			SDL_Vertex { { cx - ax - bx, cy - ay - by }, color, { u0, v0 } });
+	b.vertices.push_back(
+			SDL_Vertex { { cx + ax - bx, cy + ay - by }, color, { u1, v0 } });
+	b.vertices.push_back(
+			SDL_Vertex { { cx + ax + bx, cy + ay + by }, color, { u1, v1 } });
+	b.vertices.push_back(
+			SDL_Vertex { { cx - ax + bx, cy - ay + by }, color, { u0, v1 } });
+
+	_numSprites++;
+}
+
+void SpriteBatch::draw(const Texture &tex, const SDL_FRect &dest,
+		float angle) {
+	SDL_FRect src { 0.0f, 0.0f, static_cast<float>(tex.width()),
+			static_cast<float>(tex.height()) };
+	draw(tex, src, dest, angle);
+}
+
+void SpriteBatch::flush() {
+	for (std::size_t i : _used) {
+		Bucket &b = _buckets[i];
+		assert(!b.vertices.empty());
+
+		// the indices are the same for all textures, grow them on demand
+		std::size_t quads = b.vertices.size() / 4;
+		std::size_t have = _indices.size() / 6;
+		if (have < quads) {
+			_indices.resize(quads * 6);
+			for (std::size_t q = have; q < quads; q++) {
+				int *idx = &_indices[q * 6];
+				int v = static_cast<int>(q * 4);
+				idx[0] = v;
+				idx[1] = v + 1;
+				idx[2] = v + 2;
+				idx[3] = v + 2;
+				idx[4] = v + 3;
+				idx[5] = v;
+			}
+		}
+
+		b.tex->renderGeometry(b.vertices.data(),
+				static_cast<int>(b.vertices.size()), _indices.data(),
+				static_cast<int>(quads * 6));
+		_numDrawCalls++;
+		b.flushed = true;
+
+		b.vertices.clear(); // keeps the capacity
+	}
+
+	// only the buckets used in this flush are kept: the textures of the
+	// others might be destroyed, and a new one might get the same address.
+	// Their vertex buffers are kept for new buckets.
+	std::size_t n = 0;
+	for (std::size_t i = 0; i < _buckets.size(); i++)
+		if (_buckets[i].flushed) {
+			_buckets[i].flushed = false;
+			if (i != n)
+				std::swap(_buckets[n], _buckets[i]);
+			n++;
+		}
+	while (_buckets.size() > n) {
+		_spare.push_back(std::move(_buckets.back().vertices));
+		_buckets.pop_back();
+	}
+	_used.clear();
+	_last = 0;
+}
@@ -0,0 +1,104 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <SDL.h>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class RotationCache;
+class Texture;
+
+/*
+ * Collects sprites (textured quads, possibly rotated) and renders them
+ * with one SDL_RenderGeometry per texture, instead of one
+ * SDL_RenderTexture(Rotated) per sprite. Textures that are views of the
+ * same atlas (see Texture(atlas, region)) count as one texture.
+ *
+ * The quads of each texture go to their own vertex buffer, and flush()
+ * renders the buffers in the order in which their textures were first
+ * used since the previous flush. So sprites of the same texture keep
+ * their order, but a sprite might be drawn below one of another texture
+ * that was added before it. Call flush() where the order between textures
+ * matters (e.g., before drawing a layer that must be on top), and always
+ * before presenting the renderer -- SDLUtils::presentRenderer() does it.
+ *
+ * Only the textures used in the last flush have a buffer, but the buffers
+ * are reused, so once they have grown nothing is allocated.
+ *
+ * A texture can have a RotationCache (see setRotations), then the complete
+ * texture drawn rotated is drawn as the nearest pre-rotated frame, not
+ * rotated -- cheaper for the software renderer.
+ */
+class SpriteBatch {
+public:
+
+	SpriteBatch();
+	virtual ~SpriteBatch();
+
+	SpriteBatch(const SpriteBatch&) = delete;
+	SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+	// Adds part of the texture (src) drawn at dest, rotated 'angle' degrees
+	// (clockwise) around the center of dest -- like Texture::render(src,
+	// dest, angle). The texture is multiplied by 'color' (e.g., to tint
+	// white glyphs), white leaves it as it is.
+	//
+	void draw(const Texture &tex, const SDL_FRect &src, const SDL_FRect &dest,
+			float angle = 0.0f, SDL_FColor color = { 1.0f, 1.0f, 1.0f, 1.0f });
+
+	// Adds the complete texture drawn at dest, rotated 'angle' degrees.
+	//
+	void draw(const Texture &tex, const SDL_FRect &dest, float angle = 0.0f);
+
+	// From now on, the complete 'tex' drawn rotated is drawn with the frames
+	// of 'rotations' (nullptr to stop it). The cache must outlive its use.
+	//
+	void setRotations(const Texture &tex, const RotationCache *rotations);
+
+	// Renders everything added since the previous flush, one
+	// SDL_RenderGeometry per texture.
+	//
+	void flush();
+
+	// Number of sprites and of SDL_RenderGeometry calls since the last call
+	// to resetStats(), e.g., to compare them once per frame.
+	//
+	inline std::size_t numSprites() const {
+		return _numSprites;
+	}
+
+	inline std::size_t numDrawCalls() const {
+		return _numDrawCalls;
+	}
+
+	inline void resetStats() {
+		_numSprites = 0;
+		_numDrawCalls = 0;
+	}
+
+private:
+	struct Bucket {
+		SDL_Texture *sdlTex; // shared by all the views of an atlas
+		const Texture *tex; // the last one drawn, to render
+		std::vector<SDL_Vertex> vertices; // 4 per quad
+		bool flushed; // used in the current flush
+	};
+
+	Bucket& bucket(const Texture &tex);
+
+	const RotationCache* rotations(const Texture &tex) const;
+
+	std::vector<Bucket> _buckets; // one per texture used since the last flush
+	std::vector<std::size_t> _used; // buckets with quads, in order of first use
+	std::size_t _last; // bucket of the previous draw, most draws repeat it
+	std::vector<std::vector<SDL_Vertex>> _spare; // buffers of dropped buckets
+	std::vector<int> _indices; // 0,1,2,2,3,0, 4,5,6,6,7,4, ...
+
+	// textures with pre-rotated frames, only a few
+	std::vector<std::pair<const Texture*, const RotationCache*>> _rotations;
+
+	std::size_t _numSprites;
+	std::size_t _numDrawCalls;
+};
@@ -0,0 +1,159 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "TextRenderer.h"
+
+#include <algorithm>
+#include <cassert>
+
+TextRenderer::TextRenderer() :
+		_renderer(nullptr), //
+		_atlases(), //
+		_cache(), //
+		_numTexturesCreated(0) {
+}
+
+TextRenderer::~TextRenderer() {
+}
+
+void TextRenderer::clear() {
+	_cache.clear();
+	_atlases.clear();
+}
+
+static inline Uint32 packColor(SDL_Color c) {
+	return (Uint32(c.r) << 24) | (Uint32(c.g) << 16) | (Uint32(c.b) << 8)
+			| Uint32(c.a);
+}
+
+// ---- Cached strings ----
+
+const Texture& TextRenderer::cached(const Font &font, const std::string &text,
+		SDL_Color color) {
+	assert(_renderer != nullptr);
+
+	KeyRef ref { &font, packColor(color), text };
+	auto it = _cache.find(ref);
+	if (it == _cache.end()) {
+		it = _cache.emplace(Key { &font, packColor(color), text },
+				Texture(_renderer, text, font, color)).first;
+		_numTexturesCreated++;
+	}
+	return it->second;
+}
+
+// ---- Glyph atlas ----
+
+std::size_t TextRenderer::charIndex(char c) {
+	Uint32 ch = static_cast<unsigned char>(c);
+	if (ch < FIRST_CHAR || ch > LAST_CHAR)
+		ch = '?';
+	return ch - FIRST_CHAR;
+}
+
+TextRenderer::Atlas& TextRenderer::atlas(const Font &font) {
+	auto it = _atlases.find(&font);
+	if (it != _atlases.end())
+		return *it->second;
+
+	auto a = std::make_unique<Atlas>();
+	buildAtlas(font, *a);
+	return *(_atlases[&font] = std::move(a));
+}
+
+void TextRenderer::buildAtlas(const Font &font, Atlas &a) {
+	assert(_renderer != nullptr);
+
+	constexpr int MAX_WIDTH = 512; // of the atlas, the glyphs go in rows
+	constexpr int PADDING = 1; // between glyphs, so filtering does not mix them
+
+	// render all the glyphs in white (the color is given when drawing)
+	const SDL_Color white { 255, 255, 255, 255 };
+	SDL_Surface *glyphs[NUM_CHARS];
+	SDL_Rect pos[NUM_CHARS];
+	int x = 0, y = 0, rowHeight = 0, width = 0;
+	for (std::size_t i = 0; i < NUM_CHARS; i++) {
+		Uint32 ch = FIRST_CHAR + static_cast<Uint32>(i);
+		glyphs[i] = font.renderGlyph(ch, white);
+		int w = glyphs[i] != nullptr ? glyphs[i]->w : 0;
+		int h = glyphs[i] != nullptr ? glyphs[i]->h : 0;
+
+		if (x + w > MAX_WIDTH) {
+			x = 0;
+			y += rowHeight + PADDING;
+			rowHeight = 0;
+		}
+		pos[i] = SDL_Rect { x, y, w, h };
+		x += w + PADDING;
+		rowHeight = std::max(rowHeight, h);
+		width = std::max(width, x);
+
+		a.glyphs[i].src = SDL_FRect { static_cast<float>(pos[i].x),
+				static_cast<float>(pos[i].y), static_cast<float>(w),
+				static_cast<float>(h) };
+		a.glyphs[i].advance = static_cast<float>(font.glyphAdvance(ch));
+	}
+	int height = y + rowHeight;
+
+	// copy them to one surface, that becomes the texture
+	SDL_Surface *surface = SDL_CreateSurface(std::max(width, 1),
+			std::max(height, 1), SDL_PIXELFORMAT_RGBA32);
+	assert(surface != nullptr);
+	for (std::size_t i = 0; i < NUM_CHARS; i++) {
+		if (glyphs[i] == nullptr)
+			continue;
+		SDL_BlitSurface(glyphs[i], nullptr, surface, &pos[i]);
+		SDL_DestroySurface(glyphs[i]);
+	}
+	a.texture = Texture(_renderer, surface);
+	SDL_DestroySurface(surface);
+	_numTexturesCreated++;
+
+	a.kerning.resize(NUM_CHARS * NUM_CHARS);
+	for (std::size_t p = 0; p < NUM_CHARS; p++)
+		for (std::size_t c = 0; c < NUM_CHARS; c++)
+			a.kerning[p * NUM_CHARS + c] = font.kerning(
+					FIRST_CHAR + static_cast<Uint32>(p),
+					FIRST_CHAR + static_cast<Uint32>(c));
+
+	a.height = static_cast<float>(font.height());
+}
+
+void TextRenderer::draw(SpriteBatch &batch, const Font &font,
+		const std::string &text, float x, float y, SDL_Color color) {
+	Atlas &a = atlas(font);
+	SDL_FColor fcolor { color.r / 255.0f, color.g / 255.0f, color.b / 255.0f,
+			color.a / 255.0f };
+
+	std::size_t prev = NUM_CHARS;
+	for (char c : text) {
+		std::size_t i = charIndex(c);
+		if (prev != NUM_CHARS)
+			x += static_cast<float>(a.kerning[prev * NUM_CHARS + i]);
+
+		const Glyph &g = a.glyphs[i];
+		if (g.src.w > 0.0f) {
+			SDL_FRect dest { x, y, g.src.w, g.src.h };
+			batch.draw(a.texture, g.src, dest, 0.0f, fcolor);
+		}
+		x += g.advance;
+		prev = i;
+	}
+}
+
+float TextRenderer::width(const Font &font, const std::string &text) {
+	Atlas &a = atlas(font);
+	float w = 0.0f;
+	std::size_t prev = NUM_CHARS;
+	for (char c : text) {
+		std::size_t i = charIndex(c);
+		if (prev != NUM_CHARS)
+			w += static_cast<float>(a.kerning[prev * NUM_CHARS + i]);
+		w += a.glyphs[i].advance;
+		prev = i;
+	}
+	return w;
+}
+
+float TextRenderer::height(const Font &font) {
+	return atlas(font).height;
+}
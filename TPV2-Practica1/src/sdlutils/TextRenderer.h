@@ -0,0 +1,140 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <SDL.h>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Font.h"
+#include "SpriteBatch.h"
+#include "Texture.h"
+
+/*
+ * Text without creating a texture on each frame. There are two ways:
+ *
+ * - cached(font, text, color): a texture with the complete text, created
+ *   the first time the (font, text, color) combination is asked for and
+ *   then kept. Use it for strings that do not change (titles, menus).
+ *
+ * - draw(batch, font, text, x, y, color): the characters are quads of a
+ *   glyph atlas -- one texture per font with all printable ASCII
+ *   characters, rendered in white once -- added to a sprite batch and
+ *   tinted with 'color'. Use it for strings that change (scores, counters),
+ *   they cost nothing more than the quads.
+ *
+ * Either way, once a string has been drawn there are no more calls to
+ * SDL_ttf and no more textures are created. numTexturesCreated() counts
+ * them, to check it.
+ *
+ * The textures must be destroyed before the renderer and the fonts, see
+ * clear().
+ */
+class TextRenderer {
+public:
+
+	TextRenderer();
+	virtual ~TextRenderer();
+
+	TextRenderer(const TextRenderer&) = delete;
+	TextRenderer& operator=(const TextRenderer&) = delete;
+
+	// The renderer of the textures, must be set before using the other
+	// methods.
+	//
+	inline void setRenderer(SDL_Renderer *renderer) {
+		_renderer = renderer;
+	}
+
+	// The texture of 'text' (as created by Texture(renderer, text, font,
+	// color)), created only the first time.
+	//
+	const Texture& cached(const Font &font, const std::string &text,
+			SDL_Color color);
+
+	// Adds the characters of 'text' to 'batch', with the top-left corner at
+	// (x,y). Characters that are not printable ASCII are drawn as '?'.
+	//
+	void draw(SpriteBatch &batch, const Font &font, const std::string &text,
+			float x, float y, SDL_Color color);
+
+	// Size of 'text' when drawn with draw().
+	//
+	float width(const Font &font, const std::string &text);
+	float height(const Font &font);
+
+	// Destroys all the textures (atlases and cached strings).
+	//
+	void clear();
+
+	inline std::size_t numTexturesCreated() const {
+		return _numTexturesCreated;
+	}
+
+private:
+	static constexpr Uint32 FIRST_CHAR = 32; // ' '
+	static constexpr Uint32 LAST_CHAR = 126; // '~'
+	static constexpr std::size_t NUM_CHARS = LAST_CHAR - FIRST_CHAR + 1;
+
+	struct Glyph {
+		SDL_FRect src; // in the atlas
+		float advance;
+	};
+
+	struct Atlas {
+		Texture texture;
+		Glyph glyphs[NUM_CHARS];
+		std::vector<int> kerning; // NUM_CHARS x NUM_CHARS, [prev][ch]
+		float height;
+	};
+
+	// key of a cached string
+	struct Key {
+		const Font *font;
+		Uint32 color;
+		std::string text;
+	};
+
+	// compares keys without building a Key (and copying the text) to look
+	// up a string
+	struct KeyLess {
+		using is_transparent = void;
+
+		template<typename A, typename B>
+		bool operator()(const A &a, const B &b) const {
+			if (a.font != b.font)
+				return a.font < b.font;
+			if (a.color != b.color)
+				return a.color < b.color;
+			return textOf(a) < textOf(b);
+		}
+	};
+
+	struct KeyRef {
+		const Font *font;
+		Uint32 color;
+		const std::string &text;
+	};
+
+	static const std::string& textOf(const Key &k) {
+		return k.text;
+	}
+
+	static const std::string& textOf(const KeyRef &k) {
+		return k.text;
+	}
+
+	static std::size_t charIndex(char c);
+
+	Atlas& atlas(const Font &font);
+	void buildAtlas(const Font &font, Atlas &a);
+
+	SDL_Renderer *_renderer;
+	std::unordered_map<const Font*, std::unique_ptr<Atlas>> _atlases;
+	std::map<Key, Texture, KeyLess> _cache;
+	std::size_t _numTexturesCreated;
+};
@@ -11,6 +11,11 @@ Texture& Texture::operator=(Texture &&other) noexcept {
 	other._renderer = nullptr;
 	_width = other._width;
 	_height = other._height;
+	_owner = other._owner;
+	_x = other._x;
+	_y = other._y;
+	_invTexW = other._invTexW;
+	_invTexH = other._invTexH;
 
 	return *this;
 }
@@ -20,6 +25,9 @@ Texture::Texture() noexcept {
 	_renderer = nullptr;
 	_width = 0;
 	_height = 0;
+	_owner = true;
+	_x = _y = 0.0f;
+	_invTexW = _invTexH = 0.0f;
 }
 
 Texture::Texture(Texture &&other) noexcept {
@@ -29,6 +37,11 @@ Texture::Texture(Texture &&other) noexcept {
 	other._renderer = nullptr;
 	_width = other._width;
 	_height = other._height;
+	_owner = other._owner;
+	_x = other._x;
+	_y = other._y;
+	_invTexW = other._invTexW;
+	_invTexH = other._invTexH;
 }
 
 Texture::Texture(SDL_Renderer *renderer, const std::string &fileName) {
@@ -44,12 +57,39 @@ Texture::Texture(SDL_Renderer *renderer, const std::string &fileName) {
 
 	_width = surface->w;
 	_height = surface->h;
+	setTextureSize(_width, _height);
 
 	_texture = SDL_CreateTextureFromSurface(renderer, surface);
 	SDL_DestroySurface(surface);
 	assert(_texture != nullptr);
 }
 
+Texture::Texture(SDL_Renderer *renderer, SDL_Surface *surface) {
+	assert(renderer != nullptr && surface != nullptr);
+	_renderer = renderer;
+
+	_width = surface->w;
+	_height = surface->h;
+	setTextureSize(_width, _height);
+
+	_texture = SDL_CreateTextureFromSurface(renderer, surface);
+	assert(_texture != nullptr);
+}
+
+Texture::Texture(SDL_Renderer *renderer, int width, int height) {
+	assert(renderer != nullptr && width > 0 && height > 0);
+	_renderer = renderer;
+
+	_width = width;
+	_height = height;
+	setTextureSize(_width, _height);
+
+	_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+			SDL_TEXTUREACCESS_TARGET, width, height);
+	assert(_texture != nullptr);
+	SDL_SetTextureBlendMode(_texture, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+}
+
 Texture::Texture(SDL_Renderer *renderer, const std::string &text,
 		const Font &font, const SDL_Color &fgColor) {
 	constructFromText(renderer, text, font, &fgColor);
@@ -74,8 +114,29 @@ void Texture::constructFromText(SDL_Renderer *renderer, const std::string &text,
 
 	_width = textSurface->w;
 	_height = textSurface->h;
+	setTextureSize(_width, _height);
 
 	_texture = SDL_CreateTextureFromSurface(renderer, textSurface);
 	SDL_DestroySurface(textSurface);
 	assert(_texture != nullptr);
 }
+
+Texture::Texture(const Texture &atlas, const SDL_Rect &region) {
+	assert(atlas._texture != nullptr);
+	_texture = atlas._texture;
+	_renderer = atlas._renderer;
+	_width = region.w;
+	_height = region.h;
+	_owner = false;
+	_x = atlas._x + region.x;
+	_y = atlas._y + region.y;
+	_invTexW = atlas._invTexW;
+	_invTexH = atlas._invTexH;
+}
+
+void Texture::setTextureSize(int w, int h) {
+	_owner = true;
+	_x = _y = 0.0f;
+	_invTexW = w > 0 ? 1.0f / w : 0.0f;
+	_invTexH = h > 0 ? 1.0f / h : 0.0f;
+}
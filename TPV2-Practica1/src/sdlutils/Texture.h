@@ -37,9 +37,24 @@ public:
 	Texture(SDL_Renderer *renderer, const std::string &text, const Font &font,
 			const SDL_Color &fgColor, const SDL_Color &bgColor);
 
+	// Construct from a surface, e.g., one composed by hand. The surface
+	// is not destroyed.
+	Texture(SDL_Renderer *renderer, SDL_Surface *surface);
+
+	// Construct an empty (transparent) texture that can be used as a render
+	// target. What is rendered to it with SDL_BLENDMODE_BLEND ends up with
+	// premultiplied alpha, so it is drawn with
+	// SDL_BLENDMODE_BLEND_PREMULTIPLIED.
+	Texture(SDL_Renderer *renderer, int width, int height);
+
+	// Construct a view of the part 'region' of 'atlas' (e.g., one image of
+	// a texture atlas). It behaves as a texture of the size of the region,
+	// but it does not own the SDL texture, so 'atlas' must outlive it.
+	Texture(const Texture &atlas, const SDL_Rect &region);
+
 
 	virtual ~Texture() {
-		if (_texture != nullptr)
+		if (_texture != nullptr && _owner)
 			SDL_DestroyTexture(_texture); // delete the SDL texture
 	}
 
@@ -51,6 +66,25 @@ public:
 		return _height;
 	}
 
+	// The SDL texture, shared by all the views of the same atlas
+	inline SDL_Texture* sdlTexture() const {
+		return _texture;
+	}
+
+	// The normalized texture coordinates (in [0,1] wrt. the whole SDL
+	// texture) of the part 'src' of this texture, e.g., to build the
+	// vertices for renderGeometry.
+	inline SDL_FRect uv(const SDL_FRect &src) const {
+		return SDL_FRect { (_x + src.x) * _invTexW, (_y + src.y) * _invTexH, //
+				src.w * _invTexW, src.h * _invTexH };
+	}
+
+	// The same, for the complete texture
+	inline SDL_FRect uv() const {
+		return uv(SDL_FRect { 0.0f, 0.0f, static_cast<float>(_width),
+				static_cast<float>(_height) });
+	}
+
 	// This rendering method corresponds to method SDL_RenderCopyEx.
 	//
 	// Renders part of the texture (src) to a destination rectangle (dest)
@@ -62,7 +96,8 @@ public:
 			const SDL_FPoint *p = nullptr,
 			SDL_FlipMode flip = SDL_FLIP_NONE) const {
 		assert(_texture != nullptr);
-		SDL_RenderTextureRotated(_renderer, _texture, &src, &dest, angle, p, flip);
+		SDL_FRect s = { _x + src.x, _y + src.y, src.w, src.h };
+		SDL_RenderTextureRotated(_renderer, _texture, &s, &dest, angle, p, flip);
 	}
 
 	// This rendering method corresponds to method SDL_RenderCopy.
@@ -73,7 +108,8 @@ public:
 	// saves some checks ...
 	inline void render(const SDL_FRect &src, const SDL_FRect &dest) const {
 		assert(_texture != nullptr);
-		SDL_RenderTexture(_renderer, _texture, &src, &dest);
+		SDL_FRect s = { _x + src.x, _y + src.y, src.w, src.h };
+		SDL_RenderTexture(_renderer, _texture, &s, &dest);
 	}
 
 	// render the complete texture at position (x,y).
@@ -95,6 +131,19 @@ public:
 		render(src, dest, rotation);
 	}
 
+	// This rendering method corresponds to method SDL_RenderGeometry.
+	//
+	// Renders triangles textured with this texture, in one call. The
+	// texture coordinates of the vertices are normalized ([0,1]) wrt. the
+	// whole SDL texture -- for a view of an atlas use uv() to get the ones
+	// of its region -- and every 3 indices are a triangle.
+	inline void renderGeometry(const SDL_Vertex *vertices, int numVertices,
+			const int *indices, int numIndices) const {
+		assert(_texture != nullptr);
+		SDL_RenderGeometry(_renderer, _texture, vertices, numVertices, indices,
+				numIndices);
+	}
+
 private:
 
 	// Construct from text
@@ -102,8 +151,17 @@ private:
 			const Font &font, const SDL_Color *fgColor,
 			const SDL_Color *bgColor = nullptr);
 
+	// size of the whole SDL texture, for uv()
+	void setTextureSize(int w, int h);
+
 	SDL_Texture *_texture;
 	SDL_Renderer *_renderer;
 	int _width;
 	int _height;
+
+	bool _owner; // false for views, the SDL texture is not destroyed
+	float _x; // position of the region in the SDL texture (0,0 if not a view)
+	float _y;
+	float _invTexW; // 1/size of the whole SDL texture
+	float _invTexH;
 };
@@ -68,6 +68,19 @@ public:
 		return _currTime;
 	}
 
+	// Move the time forward 'ms' milliseconds, regardless of the real time.
+	// It is meant for loops driven by ticks (e.g., headless simulations),
+	// where it is called instead of regCurrTime, so the simulation runs as
+	// fast as possible and always sees the same times.
+	//
+	inline Uint64 step(Uint64 ms) {
+		if (!_paused) {
+			_deltaTime = ms;
+			_currTime += ms;
+		}
+		return _currTime;
+	}
+
 	// Return the last registered time
 	inline Uint64 currTime() const {
 		return _currTime;
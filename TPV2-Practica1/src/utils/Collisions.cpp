@@ -2,34 +2,38 @@
 
 #include "Collisions.h"
 
+#include "FastRotation.h"
+
 bool Collisions::collidesWithRotation(const Vector2D &o1Pos, float o1Width,
 		float o1Height, float o1Rot, const Vector2D &o2Pos, float o2Width,
 		float o2Height, float o2Rot) {
 	Vector2D Ac = o1Pos + Vector2D(o1Width / 2.0f, o1Height / 2.0f);
 
-	float angleA = o1Rot;
+	// sine and cosine of each angle are computed once for the 4 corners, and
+	// taken from the table when they are multiple of 5 (fighter, bullets)
+	SinCos angleA = fastrot::steps5().get(o1Rot);
 
 	Vector2D Alu = Ac
-			+ Vector2D(-o1Width / 2.0f, -o1Height / 2.0f).rotate(angleA);
+			+ Vector2D(-o1Width / 2.0f, -o1Height / 2.0f).rotate(angleA.sin, angleA.cos);
 	Vector2D Aru = Ac
-			+ Vector2D(o1Width / 2.0f, -o1Height / 2.0f).rotate(angleA);
+			+ Vector2D(o1Width / 2.0f, -o1Height / 2.0f).rotate(angleA.sin, angleA.cos);
 	Vector2D All = Ac
-			+ Vector2D(-o1Width / 2.0f, o1Height / 2.0f).rotate(angleA);
+			+ Vector2D(-o1Width / 2.0f, o1Height / 2.0f).rotate(angleA.sin, angleA.cos);
 	Vector2D Arl = Ac
-			+ Vector2D(o1Width / 2.0f, o1Height / 2.0f).rotate(angleA);
+			+ Vector2D(o1Width / 2.0f, o1Height / 2.0f).rotate(angleA.sin, angleA.cos);
 
-	float angleB = o2Rot;
+	SinCos angleB = fastrot::steps5().get(o2Rot);
 
 	Vector2D Bc = o2Pos + Vector2D(o2Width / 2.0f, o2Height / 2.0f);
 
 	Vector2D Blu = Bc
-			+ Vector2D(-o2Width / 2.0f, -o2Height / 2.0f).rotate(angleB);
+			+ Vector2D(-o2Width / 2.0f, -o2Height / 2.0f).rotate(angleB.sin, angleB.cos);
 	Vector2D Bru = Bc
-			+ Vector2D(o2Width / 2.0f, -o2Height / 2.0f).rotate(angleB);
+			+ Vector2D(o2Width / 2.0f, -o2Height / 2.0f).rotate(angleB.sin, angleB.cos);
 	Vector2D Bll = Bc
-			+ Vector2D(-o2Width / 2.0f, o2Height / 2.0f).rotate(angleB);
+			+ Vector2D(-o2Width / 2.0f, o2Height / 2.0f).rotate(angleB.sin, angleB.cos);
 	Vector2D Brl = Bc
-			+ Vector2D(o2Width / 2.0f, o2Height / 2.0f).rotate(angleB);
+			+ Vector2D(o2Width / 2.0f, o2Height / 2.0f).rotate(angleB.sin, angleB.cos);
 
 	return PointInRectangle(Alu, Aru, All, Arl, Blu)
 			|| PointInRectangle(Alu, Aru, All, Arl, Bru)
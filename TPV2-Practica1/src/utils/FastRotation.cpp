@@ -0,0 +1,121 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "FastRotation.h"
+
+#include <cassert>
+#include <cmath>
+
+#include "simd.h"
+
+#define PI 3.14159265358979323846264338327950288f
+
+SinCos SinCos::fromDegrees(float degrees) {
+	degrees = fmodf(degrees, 360.0f);
+	if (degrees > 180.0f) {
+		degrees = degrees - 360.0f;
+	} else if (degrees <= -180.0f) {
+		degrees = 360.0f + degrees;
+	}
+
+	assert(degrees >= -180.0f && degrees <= 180.0f);
+
+	float angle = degrees * PI / 180.0f;
+	return { sinf(angle), cosf(angle) };
+}
+
+SinCosTable::SinCosTable(float step) :
+		_step(step), _table() {
+	assert(step > 0.0f);
+	int n = static_cast<int>(std::lround(360.0f / step));
+	_table.reserve(n);
+	for (int i = 0; i < n; i++)
+		_table.push_back(SinCos::fromDegrees(i * step));
+}
+
+SinCos SinCosTable::get(float degrees) const {
+	float k = std::round(degrees / _step);
+
+	// not a multiple of step, compute it
+	if (k * _step != degrees)
+		return SinCos::fromDegrees(degrees);
+
+	int n = static_cast<int>(_table.size());
+	int i = static_cast<int>(std::fmod(k, static_cast<float>(n)));
+	if (i < 0)
+		i += n;
+	return _table[i];
+}
+
+namespace fastrot {
+
+const SinCos& plus1() {
+	static const SinCos r = SinCos::fromDegrees(1.0f);
+	return r;
+}
+
+const SinCos& minus1() {
+	static const SinCos r = plus1().inverse();
+	return r;
+}
+
+const SinCos& plus5() {
+	static const SinCos r = SinCos::fromDegrees(5.0f);
+	return r;
+}
+
+const SinCos& minus5() {
+	static const SinCos r = plus5().inverse();
+	return r;
+}
+
+const SinCosTable& steps5() {
+	static const SinCosTable t(5.0f);
+	return t;
+}
+
+void rotate(Vector2D *vs, std::size_t n, float sine, float cosine) {
+	static_assert(sizeof(Vector2D) == 2 * sizeof(float),
+			"Vector2D must be two packed floats");
+
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	// (x0,y0,x1,y1)*cos + (y0,x0,y1,x1)*(-sin,sin,-sin,sin)
+	const __m128 c = _mm_set1_ps(cosine);
+	const __m128 s = _mm_setr_ps(-sine, sine, -sine, sine);
+	float *p = &vs[0][0];
+	for (; i + 2 <= n; i += 2) {
+		__m128 v = _mm_loadu_ps(p + 2 * i);
+		__m128 w = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+		_mm_storeu_ps(p + 2 * i,
+				_mm_add_ps(_mm_mul_ps(v, c), _mm_mul_ps(w, s)));
+	}
+#endif
+
+	for (; i < n; i++)
+		vs[i] = vs[i].rotate(sine, cosine);
+}
+
+void rotate(float *xs, float *ys, std::size_t n, float sine, float cosine) {
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	const __m128 c = _mm_set1_ps(cosine);
+	const __m128 s = _mm_set1_ps(sine);
+	for (; i + 4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps(xs + i);
+		__m128 y = _mm_loadu_ps(ys + i);
+		_mm_storeu_ps(xs + i, _mm_sub_ps(_mm_mul_ps(x, c), _mm_mul_ps(y, s)));
+		_mm_storeu_ps(ys + i, _mm_add_ps(_mm_mul_ps(x, s), _mm_mul_ps(y, c)));
+	}
+#endif
+
+	for (; i < n; i++) {
+		float x = xs[i];
+		float y = ys[i];
+		xs[i] = x * cosine - y * sine;
+		ys[i] = x * sine + y * cosine;
+	}
+}
+
+} // end of namespace
@@ -0,0 +1,74 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Vector2D.h"
+
+/*
+ * The sine and cosine of an angle. Computing them is the expensive part
+ * of Vector2D::rotate(degrees), so when the same angle is used many times
+ * we compute them once and then call Vector2D::rotate(sin,cos).
+ */
+struct SinCos {
+	float sin;
+	float cos;
+
+	// sine and cosine of 'degrees'. The angle is first normalized
+	// to (-180,180], exactly as Vector2D::rotate(degrees) does, so
+	// rotating with the result gives the same vector.
+	static SinCos fromDegrees(float degrees);
+
+	// rotation by the same angle in the opposite direction
+	inline SinCos inverse() const {
+		return { -sin, cos };
+	}
+};
+
+/*
+ * A table with the sine and cosine of all multiples of 'step' degrees in
+ * [0,360). Method get(degrees) returns the stored entry when 'degrees' is
+ * a multiple of 'step' (e.g., the rotation of the fighter, that changes in
+ * steps of 5 degrees), and computes it otherwise.
+ */
+class SinCosTable {
+public:
+	SinCosTable(float step);
+	virtual ~SinCosTable() {
+	}
+
+	SinCos get(float degrees) const;
+
+	inline float step() const {
+		return _step;
+	}
+
+private:
+	float _step;
+	std::vector<SinCos> _table;
+};
+
+namespace fastrot {
+
+// rotations by fixed angles that are used every frame (Follow turns the
+// velocity by +-1 degree, the fighter turns in steps of +-5 degrees).
+// They are computed on first use.
+//
+const SinCos& plus1();
+const SinCos& minus1();
+const SinCos& plus5();
+const SinCos& minus5();
+
+// multiples of 5 degrees, for the rotation of the fighter and its bullets
+const SinCosTable& steps5();
+
+// Rotates the 'n' vectors of 'vs' in place, using the given sine and cosine.
+// Uses SSE2 when available (2 vectors per instruction).
+void rotate(Vector2D *vs, std::size_t n, float sine, float cosine);
+
+// The same for vectors stored as separate arrays of coordinates (xs[i],ys[i])
+void rotate(float *xs, float *ys, std::size_t n, float sine, float cosine);
+
+} // end of namespace
@@ -0,0 +1,94 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "FlowField.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+FlowField::FlowField(float width, float height, float cellSize) :
+		_width(width), //
+		_height(height), //
+		_cols(std::max<std::size_t>(1, std::lround(width / cellSize))), //
+		_rows(std::max<std::size_t>(1, std::lround(height / cellSize))), //
+		_cellW(width / _cols), //
+		_cellH(height / _rows), //
+		_invWidth(1.0f / width), //
+		_invHeight(1.0f / height), //
+		_invCellW(_cols / width), //
+		_invCellH(_rows / height), //
+		_dirs(_cols * _rows), //
+		_field(_cols * _rows), //
+		_target(), //
+		_targetCell(_cols * _rows) {
+	assert(width > 0.0f && height > 0.0f && cellSize > 0.0f);
+
+	// the direction for offset (dx,dy) is the one from the center of a cell
+	// to the center of the cell dx columns and dy rows before it, that is,
+	// when the target's cell is dx columns to the left and dy rows up
+	for (std::size_t dy = 0; dy < _rows; dy++)
+		for (std::size_t dx = 0; dx < _cols; dx++) {
+			Vec2 d = delta(Vec2(dx * _cellW, dy * _cellH), Vec2());
+			_dirs[dy * _cols + dx] = d.normalizeOrZero();
+		}
+
+	setTarget(Vec2());
+}
+
+FlowField::~FlowField() {
+}
+
+bool FlowField::setTarget(Vec2 target) {
+	_target = target;
+	std::size_t col = cellX(target.x);
+	std::size_t row = cellY(target.y);
+	if (row * _cols + col == _targetCell)
+		return false;
+	_targetCell = row * _cols + col;
+
+	// copy the directions for the offsets into the cells, it is just a
+	// shift of the table (rotating rows and columns)
+	for (std::size_t y = 0; y < _rows; y++) {
+		std::size_t dy = y >= row ? y - row : y + _rows - row;
+		for (std::size_t x = 0; x < _cols; x++) {
+			std::size_t dx = x >= col ? x - col : x + _cols - col;
+			_field[y * _cols + x] = _dirs[dy * _cols + dx];
+		}
+	}
+	return true;
+}
+
+Vec2 FlowField::sample(Vec2 p) const {
+	std::size_t cell = cellY(p.y) * _cols + cellX(p.x);
+	if (cell == _targetCell)
+		return delta(p, _target);
+	return _field[cell];
+}
+
+void FlowField::sample(const Vec2Span &out, const Vec2Span &pos) const {
+	assert(out.size == pos.size);
+	for (std::size_t i = 0; i < pos.size; i++)
+		out.set(i, sample(pos[i]));
+}
+
+Vec2 FlowField::delta(Vec2 a, Vec2 b) const {
+	float dx = b.x - a.x;
+	float dy = b.y - a.y;
+	dx -= _width * std::round(dx * _invWidth);
+	dy -= _height * std::round(dy * _invHeight);
+	return Vec2(dx, dy);
+}
+
+std::size_t FlowField::cellX(float x) const {
+	// wrap into [0,_width), positions may be slightly out of the world
+	// (e.g., WrapAround places entities at -width when they leave)
+	if (x < 0.0f || x >= _width)
+		x -= _width * std::floor(x * _invWidth);
+	return std::min(static_cast<std::size_t>(x * _invCellW), _cols - 1);
+}
+
+std::size_t FlowField::cellY(float y) const {
+	if (y < 0.0f || y >= _height)
+		y -= _height * std::floor(y * _invHeight);
+	return std::min(static_cast<std::size_t>(y * _invCellH), _rows - 1);
+}
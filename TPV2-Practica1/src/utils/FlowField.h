@@ -0,0 +1,102 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Vec2.h"
+#include "Vec2Batch.h"
+
+/*
+ * A coarse flow field towards a single target on a toroidal world of
+ * width x height, i.e., a world where leaving through one side means
+ * entering through the opposite one (as with the WrapAround component).
+ *
+ * The world is divided into cols x rows cells, and each cell stores the
+ * (unit) direction of the shortest path, taking the wraparound into
+ * account, from its center to the center of the target's cell. Whoever
+ * follows the target just samples the cell where it is, the cost is O(1)
+ * per follower no matter how the directions are computed.
+ *
+ * Since the world has no obstacles and the cells tile it exactly, the
+ * field only depends on the offset (in cells) between a cell and the
+ * target's cell. So the directions (with their sqrt) are computed once for
+ * all offsets, and when the target crosses to another cell the field is
+ * rebuilt by copying them with a shift -- no math, and nothing at all
+ * while the target stays in the same cell.
+ *
+ * In the target's own cell the direction is the exact (wrapped) vector to
+ * the target, not normalized.
+ *
+ * The period (width,height) is an approximation: WrapAround moves an
+ * entity of size (w,h) that leaves through the right side to x=-w, so its
+ * actual period is width+w (and height+h), which differs from entity to
+ * entity. For entities much smaller than the world the error is a small
+ * bias near the borders. Entities that do not wrap around (e.g., with
+ * TeleportOnExit) should not use the field at all, their shortest path is
+ * just target-p.
+ */
+class FlowField {
+public:
+
+	// The cell size is adjusted so that a whole number of cells fits in
+	// each dimension, otherwise the grid would not wrap around exactly.
+	//
+	FlowField(float width, float height, float cellSize);
+	virtual ~FlowField();
+
+	// Moves the target, returns true if it crossed to another cell (and the
+	// field was rebuilt).
+	//
+	bool setTarget(Vec2 target);
+
+	inline Vec2 target() const {
+		return _target;
+	}
+
+	// Direction to follow at position p.
+	//
+	Vec2 sample(Vec2 p) const;
+
+	// out[i] = sample(pos[i])
+	//
+	void sample(const Vec2Span &out, const Vec2Span &pos) const;
+
+	// Shortest vector from a to b, taking the wraparound into account.
+	//
+	Vec2 delta(Vec2 a, Vec2 b) const;
+
+	inline std::size_t cols() const {
+		return _cols;
+	}
+
+	inline std::size_t rows() const {
+		return _rows;
+	}
+
+private:
+	std::size_t cellX(float x) const;
+	std::size_t cellY(float y) const;
+
+	float _width;
+	float _height;
+	std::size_t _cols;
+	std::size_t _rows;
+	float _cellW;
+	float _cellH;
+	float _invWidth;
+	float _invHeight;
+	float _invCellW;
+	float _invCellH;
+
+	// directions indexed by the offset (in cells) to the target's cell,
+	// _dirs[dy*_cols+dx] for dx in [0,_cols) and dy in [0,_rows)
+	std::vector<Vec2> _dirs;
+
+	// directions for the current target, indexed by cell (row*_cols+col)
+	std::vector<Vec2> _field;
+
+	Vec2 _target;
+	std::size_t _targetCell;
+};
@@ -0,0 +1,111 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+		_data(nullptr), //
+		_size(0), //
+#ifdef _WIN32
+		_file(INVALID_HANDLE_VALUE), //
+		_mapping(nullptr) {
+#else
+		_fd(-1) {
+#endif
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &fileName) {
+	close();
+
+	_file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+			nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (_file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(_file, &size) || size.QuadPart == 0) {
+		close();
+		return false;
+	}
+
+	_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (_mapping == nullptr) {
+		close();
+		return false;
+	}
+
+	_data = static_cast<const unsigned char*>(MapViewOfFile(_mapping,
+			FILE_MAP_READ, 0, 0, 0));
+	if (_data == nullptr) {
+		close();
+		return false;
+	}
+	_size = static_cast<std::size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::close() {
+	if (_data != nullptr)
+		UnmapViewOfFile(_data);
+	if (_mapping != nullptr)
+		CloseHandle(_mapping);
+	if (_file != INVALID_HANDLE_VALUE)
+		CloseHandle(_file);
+	_data = nullptr;
+	_size = 0;
+	_mapping = nullptr;
+	_file = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::open(const std::string &fileName) {
+	close();
+
+	_fd = ::open(fileName.c_str(), O_RDONLY);
+	if (_fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(_fd, &st) != 0 || st.st_size == 0) {
+		close();
+		return false;
+	}
+
+	void *p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ,
+			MAP_PRIVATE, _fd, 0);
+	if (p == MAP_FAILED) {
+		close();
+		return false;
+	}
+	_data = static_cast<const unsigned char*>(p);
+	_size = static_cast<std::size_t>(st.st_size);
+	return true;
+}
+
+void MappedFile::close() {
+	if (_data != nullptr)
+		munmap(const_cast<unsigned char*>(_data), _size);
+	if (_fd >= 0)
+		::close(_fd);
+	_data = nullptr;
+	_size = 0;
+	_fd = -1;
+}
+
+#endif
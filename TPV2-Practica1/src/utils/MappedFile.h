@@ -0,0 +1,51 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/*
+ * A file mapped to memory, read-only (mmap, or MapViewOfFile on Windows).
+ * The operating system pages it in when it is read, so opening it costs
+ * the same whatever its size, and the memory can be used directly (e.g.,
+ * as the pixels of a surface) without copying it.
+ *
+ * The memory is valid until close() or the destruction of the object.
+ */
+class MappedFile {
+public:
+
+	MappedFile();
+	virtual ~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Maps the file, false if it cannot be opened or is empty.
+	//
+	bool open(const std::string &fileName);
+	void close();
+
+	inline bool isOpen() const {
+		return _data != nullptr;
+	}
+
+	inline const unsigned char* data() const {
+		return _data;
+	}
+
+	inline std::size_t size() const {
+		return _size;
+	}
+
+private:
+	const unsigned char *_data;
+	std::size_t _size;
+#ifdef _WIN32
+	void *_file; // HANDLE
+	void *_mapping; // HANDLE
+#else
+	int _fd;
+#endif
+};
@@ -0,0 +1,84 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "NeighborGrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "ThreadPool.h"
+
+NeighborGrid::NeighborGrid(float width, float height, float cellSize) :
+		_cols(std::max(1, static_cast<int>(std::ceil(width / cellSize)))), //
+		_rows(std::max(1, static_cast<int>(std::ceil(height / cellSize)))), //
+		_invCell(1.0f / cellSize), //
+		_cellStart(_cols * _rows + 1, 0), //
+		_index(), //
+		_sortedX(), //
+		_sortedY(), //
+		_cellOf(), //
+		_counts() {
+	assert(width > 0.0f && height > 0.0f && cellSize > 0.0f);
+}
+
+NeighborGrid::~NeighborGrid() {
+}
+
+void NeighborGrid::build(const Vec2Span &pos, ThreadPool *pool) {
+	const std::size_t n = pos.size;
+	const std::size_t cells = numCells();
+	const std::size_t chunks = pool != nullptr ? pool->numChunks() : 1;
+
+	_cellOf.resize(n);
+	_index.resize(n);
+	_sortedX.resize(n);
+	_sortedY.resize(n);
+	_counts.assign(chunks * cells, 0);
+
+	// runs the body on all points, in parallel if there is a pool -- the
+	// split into chunks is the same in both passes, since n is the same
+	auto forAll = [pool, n](const ThreadPool::Body &body) {
+		if (pool != nullptr)
+			pool->parallelFor(n, body);
+		else
+			body(0, n, 0);
+	};
+
+	// 1. the cell of each point, and how many points per cell each chunk has
+	forAll([this, &pos, cells](std::size_t begin, std::size_t end,
+			std::size_t chunk) {
+		std::uint32_t *counts = _counts.data() + chunk * cells;
+		for (std::size_t i = begin; i < end; i++) {
+			std::uint32_t c = static_cast<std::uint32_t>(cellY(pos.y[i]) * _cols
+					+ cellX(pos.x[i]));
+			_cellOf[i] = c;
+			counts[c]++;
+		}
+	});
+
+	// 2. prefix sum: cell by cell, and inside a cell chunk by chunk, so the
+	// points of a cell keep their order. The counts become the offsets where
+	// each chunk writes. It is O(cells*chunks), small compared to the points
+	std::uint32_t offset = 0;
+	for (std::size_t c = 0; c < cells; c++) {
+		_cellStart[c] = offset;
+		for (std::size_t k = 0; k < chunks; k++) {
+			std::uint32_t count = _counts[k * cells + c];
+			_counts[k * cells + c] = offset;
+			offset += count;
+		}
+	}
+	_cellStart[cells] = offset;
+
+	// 3. each chunk writes its points at its offsets
+	forAll([this, &pos, cells](std::size_t begin, std::size_t end,
+			std::size_t chunk) {
+		std::uint32_t *offsets = _counts.data() + chunk * cells;
+		for (std::size_t i = begin; i < end; i++) {
+			std::uint32_t k = offsets[_cellOf[i]]++;
+			_index[k] = static_cast<std::uint32_t>(i);
+			_sortedX[k] = pos.x[i];
+			_sortedY[k] = pos.y[i];
+		}
+	});
+}
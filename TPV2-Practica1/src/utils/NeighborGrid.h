@@ -0,0 +1,120 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Vec2.h"
+#include "Vec2Batch.h"
+
+class ThreadPool;
+
+/*
+ * Neighbor queries over a set of points (e.g., the positions of the
+ * asteroids), meant to be rebuilt every tick.
+ *
+ * The world of width x height is divided into square cells, and the points
+ * are sorted by cell with a counting sort: after build(), the points of
+ * cell c are sorted()[cellStart(c) .. cellStart(c+1)), and index() maps
+ * each of them back to its position in the array passed to build(). A
+ * query only visits the cells that intersect the query circle, and the
+ * points of a cell are contiguous in memory.
+ *
+ * The counting sort runs in parallel when a ThreadPool is given: each chunk
+ * counts its points per cell, a prefix sum over (cell,chunk) gives where
+ * each chunk writes the points of each cell, and then each chunk writes its
+ * points without synchronization. It is stable, so the result does not
+ * depend on the number of threads.
+ *
+ * Points outside the world go to the nearest border cell, so they are
+ * found anyway (a query visits the border cells too when it sticks out).
+ * Queries are const and can run in parallel once build() is done.
+ */
+class NeighborGrid {
+public:
+
+	// The cell size is normally the radius of the queries, so that a query
+	// visits 3x3 cells.
+	//
+	NeighborGrid(float width, float height, float cellSize);
+	virtual ~NeighborGrid();
+
+	// Sorts the points by cell, pool can be nullptr.
+	//
+	void build(const Vec2Span &pos, ThreadPool *pool = nullptr);
+
+	// Calls f(i, q, d2) for every point i (index into the array passed to
+	// build) at position q whose squared distance d2 to p is less than
+	// radius^2. It includes p itself if it was in the array.
+	//
+	template<typename F>
+	void forEachNeighbor(Vec2 p, float radius, F &&f) const {
+		const float r2 = radius * radius;
+		const int c0 = cellX(p.x - radius);
+		const int c1 = cellX(p.x + radius);
+		const int r0 = cellY(p.y - radius);
+		const int r1 = cellY(p.y + radius);
+		const float *xs = _sortedX.data();
+		const float *ys = _sortedY.data();
+		for (int r = r0; r <= r1; r++) {
+			// the cells of a row are consecutive, so are their points
+			std::size_t begin = _cellStart[r * _cols + c0];
+			std::size_t end = _cellStart[r * _cols + c1 + 1];
+			for (std::size_t k = begin; k < end; k++) {
+				float dx = xs[k] - p.x;
+				float dy = ys[k] - p.y;
+				float d2 = dx * dx + dy * dy;
+				if (d2 < r2)
+					f(static_cast<std::size_t>(_index[k]), Vec2(xs[k], ys[k]),
+							d2);
+			}
+		}
+	}
+
+	inline std::size_t size() const {
+		return _index.size();
+	}
+
+	inline std::size_t numCells() const {
+		return _cols * _rows;
+	}
+
+	inline std::size_t cellStart(std::size_t c) const {
+		return _cellStart[c];
+	}
+
+	inline const std::vector<std::uint32_t>& index() const {
+		return _index;
+	}
+
+	inline Vec2 sorted(std::size_t k) const {
+		return Vec2(_sortedX[k], _sortedY[k]);
+	}
+
+private:
+	inline int cellX(float x) const {
+		int c = static_cast<int>(x * _invCell);
+		return x < 0.0f ? 0 : (c >= _cols ? _cols - 1 : c);
+	}
+
+	inline int cellY(float y) const {
+		int r = static_cast<int>(y * _invCell);
+		return y < 0.0f ? 0 : (r >= _rows ? _rows - 1 : r);
+	}
+
+	int _cols;
+	int _rows;
+	float _invCell;
+
+	std::vector<std::uint32_t> _cellStart; // numCells()+1 entries
+	std::vector<std::uint32_t> _index;
+	std::vector<float> _sortedX;
+	std::vector<float> _sortedY;
+
+	// scratch of build(): the cell of each point, and the counts (then the
+	// write offsets) of each chunk, _counts[chunk*numCells()+cell]
+	std::vector<std::uint32_t> _cellOf;
+	std::vector<std::uint32_t> _counts;
+};
@@ -0,0 +1,69 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "RadixSort.h"
+
+#include <cstring>
+#include <utility>
+
+namespace radix {
+
+void sort(std::uint64_t *keys, std::uint32_t *values, std::size_t n,
+		std::uint64_t *tmpKeys, std::uint32_t *tmpValues) {
+	if (n < 2)
+		return;
+
+	// the bits that are not the same in all keys, only the bytes with some
+	// of them need a pass
+	std::uint64_t all1 = ~std::uint64_t(0), any1 = 0;
+	for (std::size_t i = 0; i < n; i++) {
+		all1 &= keys[i];
+		any1 |= keys[i];
+	}
+	std::uint64_t differ = all1 ^ any1;
+
+	int passes[8];
+	int numPasses = 0;
+	for (int p = 0; p < 8; p++)
+		if ((differ >> (8 * p)) & 0xff)
+			passes[numPasses++] = p;
+
+	std::size_t count[8][256];
+	std::memset(count, 0, sizeof(std::size_t) * 256 * numPasses);
+	for (std::size_t i = 0; i < n; i++) {
+		std::uint64_t k = keys[i];
+		for (int j = 0; j < numPasses; j++)
+			count[j][(k >> (8 * passes[j])) & 0xff]++;
+	}
+
+	std::uint64_t *srcK = keys, *dstK = tmpKeys;
+	std::uint32_t *srcV = values, *dstV = tmpValues;
+	for (int j = 0; j < numPasses; j++) {
+		std::size_t *c = count[j];
+		int shift = 8 * passes[j];
+
+		// counts to positions
+		std::size_t pos = 0;
+		for (int b = 0; b < 256; b++) {
+			std::size_t k = c[b];
+			c[b] = pos;
+			pos += k;
+		}
+
+		for (std::size_t i = 0; i < n; i++) {
+			std::size_t d = c[(srcK[i] >> shift) & 0xff]++;
+			dstK[d] = srcK[i];
+			dstV[d] = srcV[i];
+		}
+
+		std::swap(srcK, dstK);
+		std::swap(srcV, dstV);
+	}
+
+	// after an odd number of passes the result is in the scratch space
+	if (srcK != keys) {
+		std::memcpy(keys, srcK, n * sizeof(std::uint64_t));
+		std::memcpy(values, srcV, n * sizeof(std::uint32_t));
+	}
+}
+
+} // namespace radix
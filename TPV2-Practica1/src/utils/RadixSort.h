@@ -0,0 +1,25 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace radix {
+
+// Sorts n 64-bit keys in increasing order, moving values[i] along with
+// keys[i] (e.g., the index of what the key belongs to). It is a LSD radix
+// sort, 8 bits per pass, so it is stable: equal keys keep their order.
+//
+// Bytes that are the same in all the keys are skipped (no histogram, no
+// pass), so keys that use only a few of their bits cost only a few passes.
+// The histograms of the other bytes are computed in one pass over the
+// keys.
+//
+// tmpKeys and tmpValues are scratch space for n elements each. The result
+// is always left in keys and values.
+//
+void sort(std::uint64_t *keys, std::uint32_t *values, std::size_t n,
+		std::uint64_t *tmpKeys, std::uint32_t *tmpValues);
+
+} // namespace radix
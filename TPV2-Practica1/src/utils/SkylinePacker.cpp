@@ -0,0 +1,90 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "SkylinePacker.h"
+
+#include <algorithm>
+#include <cassert>
+
+SkylinePacker::SkylinePacker(int width, int height) :
+		_width(width), //
+		_height(height), //
+		_usedW(0), //
+		_usedH(0), //
+		_skyline() {
+	assert(width > 0 && height > 0);
+	_skyline.push_back(Segment { 0, 0, width });
+}
+
+SkylinePacker::~SkylinePacker() {
+}
+
+int SkylinePacker::fitAt(std::size_t i, int w, int h) const {
+	int x = _skyline[i].x;
+	if (x + w > _width)
+		return -1;
+
+	// the rectangle rests on the highest segment below it
+	int y = 0;
+	int left = w;
+	while (left > 0) {
+		assert(i < _skyline.size());
+		y = std::max(y, _skyline[i].y);
+		if (y + h > _height)
+			return -1;
+		left -= _skyline[i].w;
+		i++;
+	}
+	return y;
+}
+
+bool SkylinePacker::insert(int w, int h, int &x, int &y) {
+	assert(w > 0 && h > 0);
+
+	// lowest position, then leftmost
+	std::size_t best = _skyline.size();
+	int bestY = _height;
+	for (std::size_t i = 0; i < _skyline.size(); i++) {
+		int fy = fitAt(i, w, h);
+		if (fy >= 0 && fy < bestY) {
+			best = i;
+			bestY = fy;
+		}
+	}
+	if (best == _skyline.size())
+		return false;
+
+	x = _skyline[best].x;
+	y = bestY;
+
+	// the new segment replaces the part of the skyline below the rectangle
+	Segment s { x, y + h, w };
+	std::size_t j = best;
+	int right = x + w;
+	while (j < _skyline.size() && _skyline[j].x < right) {
+		int segRight = _skyline[j].x + _skyline[j].w;
+		if (segRight <= right) {
+			j++; // completely covered
+		} else {
+			// partially covered, keep the part on the right
+			_skyline[j].w = segRight - right;
+			_skyline[j].x = right;
+			break;
+		}
+	}
+	_skyline.erase(_skyline.begin() + best, _skyline.begin() + j);
+	_skyline.insert(_skyline.begin() + best, s);
+
+	// merge with neighbours of the same height
+	for (std::size_t k = 0; k + 1 < _skyline.size();) {
+		if (_skyline[k].y == _skyline[k + 1].y) {
+			_skyline[k].w += _skyline[k + 1].w;
+			_skyline.erase(_skyline.begin() + k + 1);
+		} else {
+			k++;
+		}
+	}
+
+	_usedW = std::max(_usedW, x + w);
+	_usedH = std::max(_usedH, y + h);
+	return true;
+}
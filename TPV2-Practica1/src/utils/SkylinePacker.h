@@ -0,0 +1,64 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/*
+ * Packs rectangles into a fixed-size area (e.g., images into a texture
+ * atlas) with the skyline bottom-left heuristic: it keeps the profile of
+ * the top edge of what has been placed so far (the skyline), as a list of
+ * horizontal segments, and puts each new rectangle on the segment where it
+ * ends up lowest (and leftmost, on ties).
+ *
+ * Space below the skyline that a rectangle leaves uncovered is lost, so it
+ * packs best when rectangles are inserted from the tallest to the
+ * shortest.
+ */
+class SkylinePacker {
+public:
+
+	SkylinePacker(int width, int height);
+	virtual ~SkylinePacker();
+
+	// Finds a place for a w x h rectangle and reserves it. Returns false,
+	// and changes nothing, if it does not fit.
+	//
+	bool insert(int w, int h, int &x, int &y);
+
+	// Bounding box of everything inserted so far.
+	//
+	inline int usedWidth() const {
+		return _usedW;
+	}
+
+	inline int usedHeight() const {
+		return _usedH;
+	}
+
+	inline int width() const {
+		return _width;
+	}
+
+	inline int height() const {
+		return _height;
+	}
+
+private:
+	struct Segment {
+		int x;
+		int y; // height of the skyline along [x,x+w)
+		int w;
+	};
+
+	// the y at which a rectangle of width w would be placed if its left side
+	// is at segment i, or -1 if it does not fit there
+	int fitAt(std::size_t i, int w, int h) const;
+
+	int _width;
+	int _height;
+	int _usedW;
+	int _usedH;
+	std::vector<Segment> _skyline; // left to right, covering [0,width)
+};
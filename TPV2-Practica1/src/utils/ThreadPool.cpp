@@ -0,0 +1,104 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "ThreadPool.h"
+
+#include <cassert>
+
+ThreadPool::ThreadPool() :
+		ThreadPool(
+				std::thread::hardware_concurrency() > 1 ?
+						std::thread::hardware_concurrency() - 1 : 0) {
+}
+
+ThreadPool::ThreadPool(std::size_t workers) :
+		_workers(), //
+		_mtx(), //
+		_start(), //
+		_done(), //
+		_body(nullptr), //
+		_n(0), //
+		_chunks(0), //
+		_generation(0), //
+		_pending(0), //
+		_quit(false) {
+	_workers.reserve(workers);
+	for (std::size_t i = 0; i < workers; i++)
+		_workers.emplace_back(&ThreadPool::work, this, i + 1);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		_quit = true;
+	}
+	_start.notify_all();
+	for (auto &t : _workers)
+		t.join();
+}
+
+void ThreadPool::parallelFor(std::size_t n, const Body &body,
+		std::size_t minPerChunk) {
+	std::size_t chunks = n / (minPerChunk > 0 ? minPerChunk : 1);
+	if (chunks > numChunks())
+		chunks = numChunks();
+	if (chunks <= 1) {
+		body(0, n, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		assert(_body == nullptr); // not reentrant
+		_body = &body;
+		_n = n;
+		_chunks = chunks;
+		_pending = chunks - 1;
+		_generation++;
+	}
+	_start.notify_all();
+
+	// chunk 0 is for the calling thread
+	runChunk(0);
+
+	std::unique_lock<std::mutex> lock(_mtx);
+	_done.wait(lock, [this]() {
+		return _pending == 0;
+	});
+	_body = nullptr;
+}
+
+void ThreadPool::runChunk(std::size_t chunk) {
+	std::size_t k = _chunks;
+	(*_body)(chunk * _n / k, (chunk + 1) * _n / k, chunk);
+}
+
+void ThreadPool::work(std::size_t chunk) {
+	std::size_t seen = 0;
+	for (;;) {
+		bool mine;
+		{
+			std::unique_lock<std::mutex> lock(_mtx);
+			_start.wait(lock, [this, seen]() {
+				return _quit || _generation != seen;
+			});
+			if (_quit)
+				return;
+			seen = _generation;
+			mine = chunk < _chunks;
+		}
+
+		// loops with fewer chunks than workers leave the last ones idle
+		if (!mine)
+			continue;
+
+		runChunk(chunk);
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(_mtx);
+			last = --_pending == 0;
+		}
+		if (last)
+			_done.notify_one();
+	}
+}
@@ -0,0 +1,76 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * A fixed set of worker threads to split loops of the game into chunks,
+ * e.g., to rebuild the neighbors index of all asteroids at once.
+ *
+ * There is a single operation, parallelFor, which blocks until the whole
+ * loop is done, so the data used by the loop body does not need any
+ * synchronization as long as different iterations touch different data.
+ * The calling thread also runs chunks, so a pool of 0 workers just runs
+ * the loop sequentially.
+ *
+ * It is not reentrant: parallelFor must not be called from a loop body,
+ * nor from two threads at the same time.
+ */
+class ThreadPool {
+public:
+
+	// The body receives a range [begin,end) of the iterations, and the index
+	// of the chunk (in [0,numChunks()), e.g., to have per-chunk data).
+	//
+	using Body = std::function<void(std::size_t, std::size_t, std::size_t)>;
+
+	// By default, one worker less than the hardware threads (the calling
+	// thread is the remaining one).
+	//
+	ThreadPool();
+	ThreadPool(std::size_t workers);
+	virtual ~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Number of chunks a loop is split into (workers + 1).
+	//
+	inline std::size_t numChunks() const {
+		return _workers.size() + 1;
+	}
+
+	// Runs body on [0,n) split into k consecutive ranges of (about) the same
+	// size, chunk i is [i*n/k, (i+1)*n/k). There are as many chunks as
+	// possible with at least minPerChunk iterations each, up to numChunks(),
+	// so with minPerChunk=1 a loop of 3 iterations uses 3 chunks. When it is
+	// a single chunk the loop runs in the calling thread, where waking up
+	// the workers is slower than the loop.
+	//
+	void parallelFor(std::size_t n, const Body &body,
+			std::size_t minPerChunk = 1024);
+
+private:
+	void work(std::size_t chunk);
+	void runChunk(std::size_t chunk);
+
+	std::vector<std::thread> _workers;
+
+	std::mutex _mtx;
+	std::condition_variable _start;
+	std::condition_variable _done;
+
+	// current loop, protected by _mtx
+	const Body *_body;
+	std::size_t _n;
+	std::size_t _chunks; // chunks of the current loop, at most numChunks()
+	std::size_t _generation; // incremented for each loop
+	std::size_t _pending; // chunks of the workers not done yet
+	bool _quit;
+};
@@ -0,0 +1,186 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "TimerWheel.h"
+
+#include <cassert>
+#include <utility>
+
+TimerWheel::TimerWheel(std::uint64_t now) :
+		_now(now), //
+		_size(0), //
+		_nodes(), //
+		_free(), //
+		_heads(LEVELS * SLOTS, NIL), //
+		_firing(NIL) {
+}
+
+TimerWheel::~TimerWheel() {
+}
+
+// ** scheduling
+
+TimerWheel::TimerId TimerWheel::schedule(std::uint64_t delay, Callback cb,
+		std::uint64_t period) {
+	std::uint32_t idx;
+	if (!_free.empty()) {
+		idx = _free.back();
+		_free.pop_back();
+	} else {
+		idx = static_cast<std::uint32_t>(_nodes.size());
+		_nodes.push_back(Node { 0, 0, nullptr, NIL, NIL, NIL, 0, false });
+	}
+
+	Node &n = _nodes[idx];
+	n.expires = _now + (delay > 0 ? delay : 1);
+	n.period = period;
+	n.cb = std::move(cb);
+	n.cancelled = false;
+	link(idx);
+	_size++;
+
+	return (static_cast<TimerId>(n.gen) << 32) | idx;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+	Node *n = find(id);
+	if (n == nullptr)
+		return false;
+
+	std::uint32_t idx = static_cast<std::uint32_t>(id);
+	if (n->slot != NIL)
+		unlink(idx);
+
+	if (idx == _firing) {
+		// the callback is running, fire() releases the node when it returns
+		n->cancelled = true;
+	} else {
+		release(idx);
+	}
+	return true;
+}
+
+bool TimerWheel::pending(TimerId id) const {
+	return find(id) != nullptr;
+}
+
+TimerWheel::Node* TimerWheel::find(TimerId id) {
+	return const_cast<Node*>(static_cast<const TimerWheel*>(this)->find(id));
+}
+
+const TimerWheel::Node* TimerWheel::find(TimerId id) const {
+	if (id == INVALID)
+		return nullptr;
+	std::uint32_t idx = static_cast<std::uint32_t>(id);
+	std::uint32_t gen = static_cast<std::uint32_t>(id >> 32);
+	if (idx >= _nodes.size())
+		return nullptr;
+	const Node &n = _nodes[idx];
+	if (n.gen != gen || n.cancelled || (n.slot == NIL && idx != _firing))
+		return nullptr;
+	return &n;
+}
+
+// ** the wheels
+
+// The slot of the first wheel that covers expires-_now: wheel k covers
+// delays in [SLOTS^k, SLOTS^(k+1)), and the slot is given by the k-th group
+// of BITS bits of the expiration time. Delays beyond the last wheel are
+// placed at its end, and they cascade (and are placed again) from there.
+//
+std::uint32_t TimerWheel::slotFor(std::uint64_t expires) const {
+	std::uint64_t delta = expires - _now;
+	for (int level = 0; level < LEVELS; level++) {
+		if (delta < (static_cast<std::uint64_t>(1) << (BITS * (level + 1))))
+			return level * SLOTS
+					+ ((expires >> (BITS * level)) & (SLOTS - 1));
+	}
+	std::uint64_t last = _now + (static_cast<std::uint64_t>(1) << (BITS * LEVELS))
+			- 1;
+	return (LEVELS - 1) * SLOTS
+			+ ((last >> (BITS * (LEVELS - 1))) & (SLOTS - 1));
+}
+
+void TimerWheel::link(std::uint32_t idx) {
+	Node &n = _nodes[idx];
+	// == _now only when cascading, to the slot that is processed next
+	assert(n.expires >= _now);
+	n.slot = slotFor(n.expires);
+	n.prev = NIL;
+	n.next = _heads[n.slot];
+	if (n.next != NIL)
+		_nodes[n.next].prev = idx;
+	_heads[n.slot] = idx;
+}
+
+void TimerWheel::unlink(std::uint32_t idx) {
+	Node &n = _nodes[idx];
+	assert(n.slot != NIL);
+	if (n.prev != NIL)
+		_nodes[n.prev].next = n.next;
+	else
+		_heads[n.slot] = n.next;
+	if (n.next != NIL)
+		_nodes[n.next].prev = n.prev;
+	n.slot = NIL;
+}
+
+void TimerWheel::release(std::uint32_t idx) {
+	Node &n = _nodes[idx];
+	n.cb = nullptr;
+	n.gen++;
+	n.cancelled = false;
+	_free.push_back(idx);
+	_size--;
+}
+
+void TimerWheel::cascade(int level) {
+	std::uint32_t slot = level * SLOTS
+			+ ((_now >> (BITS * level)) & (SLOTS - 1));
+	std::uint32_t idx = _heads[slot];
+	_heads[slot] = NIL;
+	while (idx != NIL) {
+		std::uint32_t next = _nodes[idx].next;
+		_nodes[idx].slot = NIL;
+		link(idx); // goes to a lower wheel, never to this slot again
+		idx = next;
+	}
+}
+
+void TimerWheel::fire(std::uint32_t idx) {
+	Node &n = _nodes[idx];
+	if (n.period > 0) {
+		n.expires = _now + n.period;
+		link(idx);
+	}
+
+	_firing = idx;
+	n.cb();
+	_firing = NIL;
+
+	if (n.cancelled || (n.period == 0 && n.slot == NIL))
+		release(idx);
+}
+
+void TimerWheel::advance(std::uint64_t now) {
+	while (_now < now) {
+		_now++;
+
+		// when the time reaches the beginning of a slot of an upper wheel,
+		// its timers move down
+		for (int level = 1; level < LEVELS; level++) {
+			if ((_now & ((static_cast<std::uint64_t>(1) << (BITS * level)) - 1))
+					!= 0)
+				break;
+			cascade(level);
+		}
+
+		// fire the timers of the current slot of the first wheel, one by one
+		// since callbacks may cancel the others
+		std::uint32_t slot = static_cast<std::uint32_t>(_now & (SLOTS - 1));
+		while (_heads[slot] != NIL) {
+			std::uint32_t idx = _heads[slot];
+			unlink(idx);
+			fire(idx);
+		}
+	}
+}
@@ -0,0 +1,111 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+/*
+ * A hierarchical timer wheel: callbacks that are called when some time has
+ * passed, once or periodically. Time is in milliseconds and only moves
+ * when advance(now) is called, so feeding it with the time of a
+ * VirtualTimer makes the timers stop while the game is paused.
+ *
+ * There are LEVELS wheels of SLOTS slots each. The first one has one slot
+ * per millisecond, the second one per SLOTS milliseconds, etc. A timer
+ * goes to the slot of its expiration time in the first wheel that covers
+ * it, and when the time reaches the beginning of that slot it moves
+ * (cascades) to a lower wheel, until it is in the first one and fires.
+ * Scheduling and cancelling are O(1) (the slots are doubly linked lists),
+ * and advancing the time only visits the slots that are due -- timers that
+ * are not due cost nothing.
+ *
+ * Callbacks are called from advance(), and they can schedule and cancel
+ * timers, including their own. Periodic timers are rescheduled from the
+ * time they fire, so if advance() jumps over several periods they fire
+ * once (as a "now - last >= period" check would do).
+ *
+ * Whoever schedules a timer whose callback uses an object must cancel it
+ * before the object is destroyed.
+ */
+class TimerWheel {
+public:
+
+	// identifies a scheduled timer, it becomes invalid when the timer fires
+	// (if not periodic) or is cancelled
+	using TimerId = std::uint64_t;
+	static constexpr TimerId INVALID = ~static_cast<TimerId>(0);
+
+	using Callback = std::function<void()>;
+
+	TimerWheel(std::uint64_t now = 0);
+	virtual ~TimerWheel();
+
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel& operator=(const TimerWheel&) = delete;
+
+	// Calls 'cb' when 'delay' milliseconds have passed (at least 1), and
+	// then every 'period' milliseconds if period > 0.
+	//
+	TimerId schedule(std::uint64_t delay, Callback cb, std::uint64_t period = 0);
+
+	// Returns false if the timer was not pending (already fired or
+	// cancelled).
+	//
+	bool cancel(TimerId id);
+
+	bool pending(TimerId id) const;
+
+	// Moves the time to 'now' firing the timers that are due, in order of
+	// expiration. Times in the past are ignored.
+	//
+	void advance(std::uint64_t now);
+
+	inline std::uint64_t now() const {
+		return _now;
+	}
+
+	// number of pending timers
+	inline std::size_t size() const {
+		return _size;
+	}
+
+private:
+	static constexpr int BITS = 6;
+	static constexpr int SLOTS = 1 << BITS;
+	static constexpr int LEVELS = 4; // 64^4 ms, about 4.6 hours
+	static constexpr std::uint32_t NIL = 0xffffffffu;
+
+	struct Node {
+		std::uint64_t expires;
+		std::uint64_t period;
+		Callback cb;
+		std::uint32_t prev;
+		std::uint32_t next;
+		std::uint32_t slot; // NIL if not in a slot
+		std::uint32_t gen; // incremented when the node is released
+		bool cancelled; // cancelled while its callback was running
+	};
+
+	std::uint32_t slotFor(std::uint64_t expires) const;
+	void link(std::uint32_t idx);
+	void unlink(std::uint32_t idx);
+	void release(std::uint32_t idx);
+	void cascade(int level);
+	void fire(std::uint32_t idx);
+	Node* find(TimerId id);
+	const Node* find(TimerId id) const;
+
+	std::uint64_t _now;
+	std::size_t _size;
+
+	// nodes never move (deque), so a callback can schedule new timers
+	// while its node is being used
+	std::deque<Node> _nodes;
+	std::vector<std::uint32_t> _free;
+	std::vector<std::uint32_t> _heads; // LEVELS*SLOTS lists
+	std::uint32_t _firing; // node whose callback is running, or NIL
+};
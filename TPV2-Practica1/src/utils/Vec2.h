@@ -0,0 +1,145 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+#include "Vector2D.h"
+
+/*
+ * A light 2-dimensional vector for the hot loops of the game. Unlike
+ * Vector2D it is a plain struct with public coordinates: it is trivially
+ * copyable (so arrays of it can be copied with memcpy and kept in
+ * registers), and all operations that do not need sqrt are constexpr.
+ *
+ * Use toVec2/toVector2D to convert from/to the Vector2D of the components.
+ */
+struct Vec2 {
+	float x;
+	float y;
+
+	constexpr Vec2() :
+			x(0.0f), y(0.0f) {
+	}
+
+	constexpr Vec2(float x_, float y_) :
+			x(x_), y(y_) {
+	}
+
+	// ** arithmetic
+
+	constexpr Vec2 operator+(Vec2 v) const {
+		return Vec2(x + v.x, y + v.y);
+	}
+
+	constexpr Vec2 operator-(Vec2 v) const {
+		return Vec2(x - v.x, y - v.y);
+	}
+
+	constexpr Vec2 operator-() const {
+		return Vec2(-x, -y);
+	}
+
+	constexpr Vec2 operator*(float k) const {
+		return Vec2(x * k, y * k);
+	}
+
+	constexpr Vec2 operator/(float k) const {
+		return Vec2(x / k, y / k);
+	}
+
+	constexpr Vec2& operator+=(Vec2 v) {
+		x += v.x;
+		y += v.y;
+		return *this;
+	}
+
+	constexpr Vec2& operator-=(Vec2 v) {
+		x -= v.x;
+		y -= v.y;
+		return *this;
+	}
+
+	constexpr Vec2& operator*=(float k) {
+		x *= k;
+		y *= k;
+		return *this;
+	}
+
+	constexpr bool operator==(Vec2 v) const {
+		return x == v.x && y == v.y;
+	}
+
+	constexpr bool operator!=(Vec2 v) const {
+		return !(*this == v);
+	}
+
+	// ** products
+
+	constexpr float dot(Vec2 v) const {
+		return x * v.x + y * v.y;
+	}
+
+	// z-coordinate of the 3D cross product. It is positive when 'v' is
+	// counter clockwise from 'this' (clockwise on screen, since the y axis
+	// of SDL points down), i.e., when Vector2D::angle(v) is positive.
+	constexpr float cross(Vec2 v) const {
+		return x * v.y - y * v.x;
+	}
+
+	// ** length
+
+	constexpr float lengthSq() const {
+		return x * x + y * y;
+	}
+
+	inline float length() const {
+		return std::sqrt(lengthSq());
+	}
+
+	constexpr float distanceSq(Vec2 v) const {
+		return (*this - v).lengthSq();
+	}
+
+	inline float distance(Vec2 v) const {
+		return std::sqrt(distanceSq(v));
+	}
+
+	// vector in the same direction of length 1, or (0,0) if this is (0,0)
+	inline Vec2 normalizeOrZero() const {
+		float l2 = lengthSq();
+		return l2 > 0.0f ? *this * (1.0f / std::sqrt(l2)) : Vec2();
+	}
+
+	// ** rotation
+
+	// rotation given the sine and cosine of the angle (see FastRotation.h),
+	// same direction as Vector2D::rotate
+	constexpr Vec2 rotate(float sine, float cosine) const {
+		return Vec2(x * cosine - y * sine, x * sine + y * cosine);
+	}
+
+	// the vector rotated 90 degrees counter clockwise
+	constexpr Vec2 perp() const {
+		return Vec2(-y, x);
+	}
+};
+
+static_assert(std::is_trivially_copyable<Vec2>::value,
+		"Vec2 must be trivially copyable");
+static_assert(sizeof(Vec2) == 2 * sizeof(float), "Vec2 must be two floats");
+static_assert(std::is_trivially_copyable<Vector2D>::value,
+		"Vector2D must be trivially copyable");
+
+constexpr Vec2 operator*(float k, Vec2 v) {
+	return v * k;
+}
+
+inline Vec2 toVec2(const Vector2D &v) {
+	return Vec2(v.getX(), v.getY());
+}
+
+inline Vector2D toVector2D(Vec2 v) {
+	return Vector2D(v.x, v.y);
+}
@@ -0,0 +1,325 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "Vec2Batch.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "simd.h"
+
+namespace vec2batch {
+
+void add(const Vec2Span &out, const Vec2Span &a, const Vec2Span &b) {
+	assert(out.size == a.size && a.size == b.size);
+
+	std::size_t n = a.size;
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	for (; i + 4 <= n; i += 4) {
+		_mm_storeu_ps(out.x + i,
+				_mm_add_ps(_mm_loadu_ps(a.x + i), _mm_loadu_ps(b.x + i)));
+		_mm_storeu_ps(out.y + i,
+				_mm_add_ps(_mm_loadu_ps(a.y + i), _mm_loadu_ps(b.y + i)));
+	}
+#endif
+
+	for (; i < n; i++) {
+		out.x[i] = a.x[i] + b.x[i];
+		out.y[i] = a.y[i] + b.y[i];
+	}
+}
+
+void sub(const Vec2Span &out, const Vec2Span &a, const Vec2Span &b) {
+	assert(out.size == a.size && a.size == b.size);
+
+	std::size_t n = a.size;
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	for (; i + 4 <= n; i += 4) {
+		_mm_storeu_ps(out.x + i,
+				_mm_sub_ps(_mm_loadu_ps(a.x + i), _mm_loadu_ps(b.x + i)));
+		_mm_storeu_ps(out.y + i,
+				_mm_sub_ps(_mm_loadu_ps(a.y + i), _mm_loadu_ps(b.y + i)));
+	}
+#endif
+
+	for (; i < n; i++) {
+		out.x[i] = a.x[i] - b.x[i];
+		out.y[i] = a.y[i] - b.y[i];
+	}
+}
+
+void scale(const Vec2Span &out, const Vec2Span &a, float k) {
+	assert(out.size == a.size);
+
+	std::size_t n = a.size;
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	const __m128 vk = _mm_set1_ps(k);
+	for (; i + 4 <= n; i += 4) {
+		_mm_storeu_ps(out.x + i, _mm_mul_ps(_mm_loadu_ps(a.x + i), vk));
+		_mm_storeu_ps(out.y + i, _mm_mul_ps(_mm_loadu_ps(a.y + i), vk));
+	}
+#endif
+
+	for (; i < n; i++) {
+		out.x[i] = a.x[i] * k;
+		out.y[i] = a.y[i] * k;
+	}
+}
+
+void scale(const Vec2Span &out, const Vec2Span &a, const float *k) {
+	assert(out.size == a.size);
+
+	std::size_t n = a.size;
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	for (; i + 4 <= n; i += 4) {
+		__m128 vk = _mm_loadu_ps(k + i);
+		_mm_storeu_ps(out.x + i, _mm_mul_ps(_mm_loadu_ps(a.x + i), vk));
+		_mm_storeu_ps(out.y + i, _mm_mul_ps(_mm_loadu_ps(a.y + i), vk));
+	}
+#endif
+
+	for (; i < n; i++) {
+		out.x[i] = a.x[i] * k[i];
+		out.y[i] = a.y[i] * k[i];
+	}
+}
+
+void lengthSq(float *out, const Vec2Span &a) {
+	distanceSq(out, a, Vec2());
+}
+
+void normalizeOrZero(const Vec2Span &out, const Vec2Span &a) {
+	assert(out.size == a.size);
+
+	std::size_t n = a.size;
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (; i + 4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps(a.x + i);
+		__m128 y = _mm_loadu_ps(a.y + i);
+		__m128 l2 = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+		// 1/length where length > 0, and 0 otherwise (the inf of the
+		// division by 0 is masked out)
+		__m128 inv = _mm_and_ps(_mm_div_ps(one, _mm_sqrt_ps(l2)),
+				_mm_cmpgt_ps(l2, zero));
+		_mm_storeu_ps(out.x + i, _mm_mul_ps(x, inv));
+		_mm_storeu_ps(out.y + i, _mm_mul_ps(y, inv));
+	}
+#endif
+
+	for (; i < n; i++)
+		out.set(i, a[i].normalizeOrZero());
+}
+
+void distanceSq(float *out, const Vec2Span &a, Vec2 p) {
+	std::size_t n = a.size;
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	const __m128 px = _mm_set1_ps(p.x);
+	const __m128 py = _mm_set1_ps(p.y);
+	for (; i + 4 <= n; i += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(a.x + i), px);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(a.y + i), py);
+		_mm_storeu_ps(out + i,
+				_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+	}
+#endif
+
+	for (; i < n; i++)
+		out[i] = a[i].distanceSq(p);
+}
+
+float minDistanceSq(const Vec2Span &a, Vec2 p) {
+	std::size_t n = a.size;
+	if (n == 0)
+		return -1.0f;
+
+	std::size_t i = 0;
+	float best = a[0].distanceSq(p);
+
+#ifdef _USE_SSE2
+	const __m128 px = _mm_set1_ps(p.x);
+	const __m128 py = _mm_set1_ps(p.y);
+	__m128 vbest = _mm_set1_ps(best);
+	for (; i + 4 <= n; i += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(a.x + i), px);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(a.y + i), py);
+		vbest = _mm_min_ps(vbest,
+				_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+	}
+	alignas(16) float lanes[4];
+	_mm_store_ps(lanes, vbest);
+	best = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+#endif
+
+	for (; i < n; i++)
+		best = std::min(best, a[i].distanceSq(p));
+
+	return best;
+}
+
+void turnTowards(const Vec2Span &dir, const Vec2Span &pos, Vec2 target,
+		float sine, float cosine) {
+	assert(dir.size == pos.size);
+
+	std::size_t n = dir.size;
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	const __m128 tx = _mm_set1_ps(target.x);
+	const __m128 ty = _mm_set1_ps(target.y);
+	const __m128 s = _mm_set1_ps(sine);
+	const __m128 c = _mm_set1_ps(cosine);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	for (; i + 4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps(dir.x + i);
+		__m128 y = _mm_loadu_ps(dir.y + i);
+		__m128 dx = _mm_sub_ps(tx, _mm_loadu_ps(pos.x + i));
+		__m128 dy = _mm_sub_ps(ty, _mm_loadu_ps(pos.y + i));
+		__m128 cross = _mm_sub_ps(_mm_mul_ps(x, dy), _mm_mul_ps(y, dx));
+		// flip the sign of the sine where cross <= 0
+		__m128 si = _mm_xor_ps(s,
+				_mm_andnot_ps(_mm_cmpgt_ps(cross, zero), signBit));
+		_mm_storeu_ps(dir.x + i, _mm_sub_ps(_mm_mul_ps(x, c), _mm_mul_ps(y, si)));
+		_mm_storeu_ps(dir.y + i, _mm_add_ps(_mm_mul_ps(x, si), _mm_mul_ps(y, c)));
+	}
+#endif
+
+	for (; i < n; i++) {
+		Vec2 d = dir[i];
+		float si = d.cross(target - pos[i]) > 0.0f ? sine : -sine;
+		dir.set(i, d.rotate(si, cosine));
+	}
+}
+
+void turnTowards(const Vec2Span &dir, const Vec2Span &towards, float sine,
+		float cosine) {
+	assert(dir.size == towards.size);
+
+	std::size_t n = dir.size;
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	const __m128 s = _mm_set1_ps(sine);
+	const __m128 c = _mm_set1_ps(cosine);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	for (; i + 4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps(dir.x + i);
+		__m128 y = _mm_loadu_ps(dir.y + i);
+		__m128 dx = _mm_loadu_ps(towards.x + i);
+		__m128 dy = _mm_loadu_ps(towards.y + i);
+		__m128 cross = _mm_sub_ps(_mm_mul_ps(x, dy), _mm_mul_ps(y, dx));
+		// flip the sign of the sine where cross <= 0
+		__m128 si = _mm_xor_ps(s,
+				_mm_andnot_ps(_mm_cmpgt_ps(cross, zero), signBit));
+		_mm_storeu_ps(dir.x + i, _mm_sub_ps(_mm_mul_ps(x, c), _mm_mul_ps(y, si)));
+		_mm_storeu_ps(dir.y + i, _mm_add_ps(_mm_mul_ps(x, si), _mm_mul_ps(y, c)));
+	}
+#endif
+
+	for (; i < n; i++) {
+		Vec2 d = dir[i];
+		float si = d.cross(towards[i]) > 0.0f ? sine : -sine;
+		dir.set(i, d.rotate(si, cosine));
+	}
+}
+
+void wrap(const Vec2Span &pos, const Vec2Span &size, Vec2 world) {
+	assert(pos.size == size.size);
+
+	std::size_t n = pos.size;
+	std::size_t i = 0;
+
+#ifdef _USE_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 wx = _mm_set1_ps(world.x);
+	const __m128 wy = _mm_set1_ps(world.y);
+	for (; i + 4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps(pos.x + i);
+		__m128 y = _mm_loadu_ps(pos.y + i);
+		__m128 w = _mm_loadu_ps(size.x + i);
+		__m128 h = _mm_loadu_ps(size.y + i);
+
+		// first choose between x and world.x (left), then -w (right) wins
+		__m128 left = _mm_cmplt_ps(_mm_add_ps(x, w), zero);
+		__m128 right = _mm_cmpgt_ps(x, wx);
+		x = _mm_or_ps(_mm_and_ps(left, wx), _mm_andnot_ps(left, x));
+		x = _mm_or_ps(_mm_and_ps(right, _mm_sub_ps(zero, w)),
+				_mm_andnot_ps(right, x));
+
+		__m128 top = _mm_cmplt_ps(_mm_add_ps(y, h), zero);
+		__m128 bottom = _mm_cmpgt_ps(y, wy);
+		y = _mm_or_ps(_mm_and_ps(top, wy), _mm_andnot_ps(top, y));
+		y = _mm_or_ps(_mm_and_ps(bottom, _mm_sub_ps(zero, h)),
+				_mm_andnot_ps(bottom, y));
+
+		_mm_storeu_ps(pos.x + i, x);
+		_mm_storeu_ps(pos.y + i, y);
+	}
+#endif
+
+	for (; i < n; i++) {
+		float x = pos.x[i];
+		float y = pos.y[i];
+		float w = size.x[i];
+		float h = size.y[i];
+		pos.x[i] = x > world.x ? -w : (x + w < 0.0f ? world.x : x);
+		pos.y[i] = y > world.y ? -h : (y + h < 0.0f ? world.y : y);
+	}
+}
+
+std::size_t outside(std::uint32_t *out, const Vec2Span &pos,
+		const Vec2Span &size, Vec2 world) {
+	assert(pos.size == size.size);
+
+	std::size_t n = pos.size;
+	std::size_t i = 0;
+	std::size_t k = 0;
+
+#ifdef _USE_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 wx = _mm_set1_ps(world.x);
+	const __m128 wy = _mm_set1_ps(world.y);
+	for (; i + 4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps(pos.x + i);
+		__m128 y = _mm_loadu_ps(pos.y + i);
+		__m128 out4 = _mm_or_ps(
+				_mm_or_ps(
+						_mm_cmplt_ps(_mm_add_ps(x, _mm_loadu_ps(size.x + i)),
+								zero), _mm_cmpgt_ps(x, wx)),
+				_mm_or_ps(
+						_mm_cmplt_ps(_mm_add_ps(y, _mm_loadu_ps(size.y + i)),
+								zero), _mm_cmpgt_ps(y, wy)));
+		// almost always 0, the lanes are only visited when some box is out
+		int mask = _mm_movemask_ps(out4);
+		for (int lane = 0; mask != 0; lane++, mask >>= 1)
+			if (mask & 1)
+				out[k++] = static_cast<std::uint32_t>(i + lane);
+	}
+#endif
+
+	for (; i < n; i++) {
+		float x = pos.x[i];
+		float y = pos.y[i];
+		if (x + size.x[i] < 0.0f || x > world.x || y + size.y[i] < 0.0f
+				|| y > world.y)
+			out[k++] = static_cast<std::uint32_t>(i);
+	}
+
+	return k;
+}
+
+} // end of namespace
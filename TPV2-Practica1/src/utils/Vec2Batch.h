@@ -0,0 +1,151 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Vec2.h"
+
+/*
+ * A view of 'size' vectors stored as two separate arrays of coordinates
+ * (structure of arrays), the i-th vector is (x[i],y[i]). It does not own
+ * the memory, it is the C++17 counterpart of a std::span for vectors.
+ *
+ * Vec2Buffer owns the memory, and can be passed wherever a Vec2Span is
+ * expected.
+ */
+struct Vec2Span {
+	float *x;
+	float *y;
+	std::size_t size;
+
+	inline Vec2 operator[](std::size_t i) const {
+		return Vec2(x[i], y[i]);
+	}
+
+	inline void set(std::size_t i, Vec2 v) const {
+		x[i] = v.x;
+		y[i] = v.y;
+	}
+};
+
+class Vec2Buffer {
+public:
+	Vec2Buffer() :
+			_x(), _y() {
+	}
+
+	Vec2Buffer(std::size_t n) :
+			_x(n), _y(n) {
+	}
+
+	inline void clear() {
+		_x.clear();
+		_y.clear();
+	}
+
+	inline void reserve(std::size_t n) {
+		_x.reserve(n);
+		_y.reserve(n);
+	}
+
+	inline void resize(std::size_t n) {
+		_x.resize(n);
+		_y.resize(n);
+	}
+
+	inline void push_back(Vec2 v) {
+		_x.push_back(v.x);
+		_y.push_back(v.y);
+	}
+
+	inline std::size_t size() const {
+		return _x.size();
+	}
+
+	inline Vec2 operator[](std::size_t i) const {
+		return Vec2(_x[i], _y[i]);
+	}
+
+	inline Vec2Span span() {
+		return { _x.data(), _y.data(), _x.size() };
+	}
+
+	inline operator Vec2Span() {
+		return span();
+	}
+
+private:
+	std::vector<float> _x;
+	std::vector<float> _y;
+};
+
+/*
+ * Kernels over Vec2Span. Output spans may be the same as input spans (in
+ * place operation), but must not partially overlap. All spans passed to a
+ * kernel must have the same size. They use SSE2 when available (4 vectors
+ * per instruction), with a scalar version otherwise.
+ */
+namespace vec2batch {
+
+// out[i] = a[i] + b[i]
+void add(const Vec2Span &out, const Vec2Span &a, const Vec2Span &b);
+
+// out[i] = a[i] - b[i]
+void sub(const Vec2Span &out, const Vec2Span &a, const Vec2Span &b);
+
+// out[i] = a[i] * k
+void scale(const Vec2Span &out, const Vec2Span &a, float k);
+
+// out[i] = a[i] * k[i]
+void scale(const Vec2Span &out, const Vec2Span &a, const float *k);
+
+// out[i] = a[i].lengthSq(), 'out' must have room for a.size floats
+void lengthSq(float *out, const Vec2Span &a);
+
+// out[i] = a[i].normalizeOrZero()
+void normalizeOrZero(const Vec2Span &out, const Vec2Span &a);
+
+// out[i] = a[i].distanceSq(p), 'out' must have room for a.size floats
+void distanceSq(float *out, const Vec2Span &a, Vec2 p);
+
+// minimum of a[i].distanceSq(p), or -1.0f if 'a' is empty
+float minDistanceSq(const Vec2Span &a, Vec2 p);
+
+// Turns each dir[i] by a fixed angle towards 'target', as seen from pos[i]:
+// counter clockwise (sine,cosine) when target-pos[i] is counter clockwise
+// from dir[i] (positive cross product), clockwise (-sine,cosine) otherwise.
+// It is the batch version of
+//
+//   dir = dir.rotate(dir.angle(target-pos) > 0 ? a : -a)
+//
+void turnTowards(const Vec2Span &dir, const Vec2Span &pos, Vec2 target,
+		float sine, float cosine);
+
+// Same, but each dir[i] turns towards its own direction towards[i] (e.g.,
+// sampled from a FlowField):
+//
+//   dir = dir.rotate(dir.angle(towards) > 0 ? a : -a)
+//
+void turnTowards(const Vec2Span &dir, const Vec2Span &towards, float sine,
+		float cosine);
+
+// The boxes with top-left corner pos[i] and size size[i] that leave the
+// world [0,world.x]x[0,world.y] reappear at the opposite side, each axis
+// separately:
+//
+//   x = x > world.x ? -w : (x + w < 0 ? world.x : x)
+//
+void wrap(const Vec2Span &pos, const Vec2Span &size, Vec2 world);
+
+// Writes to 'out' the indices of the boxes (pos[i],size[i]) that are
+// completely outside the world [0,world.x]x[0,world.y], in increasing
+// order, and returns how many there are. 'out' must have room for pos.size
+// indices.
+//
+std::size_t outside(std::uint32_t *out, const Vec2Span &pos,
+		const Vec2Span &size, Vec2 world);
+
+} // end of namespace
@@ -4,6 +4,8 @@
 
 #include <cassert>
 
+#include "FastRotation.h"
+
 
 #define PI 3.14159265358979323846264338327950288f
 
@@ -14,31 +16,8 @@ std::ostream& operator<<(std::ostream &os, const Vector2D &v) {
 }
 
 Vector2D Vector2D::rotate(float degrees) const {
-	Vector2D r;
-
-	degrees = fmodf(degrees, 360.0f);
-	if (degrees > 180.0f) {
-		degrees = degrees - 360.0f;
-	} else if (degrees <= -180.0f) {
-		degrees = 360.0f + degrees;
-	}
-
-	assert(degrees >= -180.0f && degrees <= 180.0f);
-
-	float angle = degrees * PI / 180.0f;
-	float sine = sinf(angle);
-	float cosine = cosf(angle);
-
-	//rotation matrix
-	float matrix[2][2] = { { cosine, -sine }, { sine, cosine } };
-
-	float x = _x;
-	float y = _y;
-
-	r._x = matrix[0][0] * x + matrix[0][1] * y;
-	r._y = matrix[1][0] * x + matrix[1][1] * y;
-
-	return r;
+	SinCos sc = SinCos::fromDegrees(degrees);
+	return rotate(sc.sin, sc.cos);
 }
 
 float Vector2D::angle(const Vector2D &v) const {
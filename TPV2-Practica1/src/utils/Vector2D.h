@@ -21,20 +21,16 @@ public:
 			_x(), _y() {
 	}
 
-	Vector2D(const Vector2D &v) noexcept :
-			_x(v.getX()), _y(v.getY()) {
-	}
-
-	Vector2D(Vector2D &&v) noexcept :
-			_x(v.getX()), _y(v.getY()) {
-	}
+	// copy/move and destruction are the default ones, this way Vector2D
+	// is trivially copyable
+	Vector2D(const Vector2D &v) noexcept = default;
+	Vector2D(Vector2D &&v) noexcept = default;
 
 	Vector2D(float x, float y) noexcept :
 			_x(x), _y(y) {
 	}
 
-	~Vector2D() {
-	}
+	~Vector2D() = default;
 
 	// various getters
 	inline float getX() const {
@@ -65,11 +61,7 @@ public:
 	}
 
 	// copy assignment
-	inline Vector2D& operator=(const Vector2D &v) noexcept {
-		_x = v._x;
-		_y = v._y;
-		return *this;
-	}
+	Vector2D& operator=(const Vector2D &v) noexcept = default;
 
 	// v[0] is the first coordinate and v[1] is the second
 	inline float& operator[](int i) noexcept {
@@ -88,7 +80,7 @@ public:
 
 	// length of the vector
 	inline float magnitude() const {
-		return sqrtf(powf(_x, 2) + powf(_y, 2));
+		return sqrtf(_x * _x + _y * _y);
 	}
 
 	// vector in the same direction of length 1
@@ -103,6 +95,14 @@ public:
 	//
 	Vector2D rotate(float degrees) const;
 
+	// the same rotation, but receiving the sine and cosine of the angle. Use
+	// it when they are precomputed (see FastRotation.h), it avoids calling
+	// sinf/cosf on each rotation.
+	//
+	inline Vector2D rotate(float sine, float cosine) const {
+		return Vector2D(_x * cosine - _y * sine, _x * sine + _y * cosine);
+	}
+
 	// Computes the angle between 'this' and 'v'. The result is
 	// between -180 and 180, and is such that the following holds:
 	//
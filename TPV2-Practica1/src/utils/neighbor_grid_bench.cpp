@@ -0,0 +1,126 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "neighbor_grid_bench.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "NeighborGrid.h"
+#include "ThreadPool.h"
+#include "Vec2Batch.h"
+
+// radius of the queries, and area per asteroid (so that the density, and
+// the average number of neighbors, is the same for all sizes)
+static const float RADIUS = 100.0f;
+static const float AREA_PER_POINT = 8000.0f;
+
+// runs f() 'reps' times and returns milliseconds per run
+template<typename F>
+static double time_per_run(F f, int reps) {
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < reps; r++)
+		f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count()
+			/ reps;
+}
+
+// n points in a square world of constant density, (pseudo) random but the
+// same in every run
+static float fill(Vec2Buffer &pos, std::size_t n) {
+	float side = std::sqrt(n * AREA_PER_POINT);
+	pos.resize(n);
+	unsigned int seed = 12345u;
+	auto next = [&seed, side]() {
+		seed = seed * 1103515245u + 12345u;
+		return (seed >> 8) * (1.0f / 16777216.0f) * side;
+	};
+	for (auto i = 0u; i < n; i++) {
+		float x = next();
+		pos.span().set(i, Vec2(x, next()));
+	}
+	return side;
+}
+
+void neighbor_grid_bench() {
+
+	const int reps = 20;
+	ThreadPool pool;
+
+	std::cout << "threads: " << pool.numChunks() << std::endl;
+
+	// ** correctness, against brute force on a small set
+
+	{
+		Vec2Buffer pos;
+		float side = fill(pos, 2000);
+		NeighborGrid grid(side, side, RADIUS);
+		grid.build(pos, &pool);
+
+		std::size_t wrong = 0;
+		for (auto i = 0u; i < pos.size(); i++) {
+			std::size_t found = 0, expected = 0;
+			grid.forEachNeighbor(pos[i], RADIUS,
+					[&found](std::size_t, Vec2, float) {
+						found++;
+					});
+			for (auto j = 0u; j < pos.size(); j++)
+				if (pos[i].distanceSq(pos[j]) < RADIUS * RADIUS)
+					expected++;
+			if (found != expected)
+				wrong++;
+		}
+		std::cout << "queries that differ from brute force: " << wrong
+				<< std::endl;
+	}
+
+	// ** scaling, build + one query per point, as the flocking does. The
+	// queries go in the order of the cells, so that consecutive queries
+	// visit the same cells (much better for the cache than the original
+	// order with many asteroids)
+
+	for (std::size_t n : { 10000u, 100000u }) {
+		Vec2Buffer pos;
+		float side = fill(pos, n);
+		NeighborGrid grid(side, side, RADIUS);
+		std::vector<std::size_t> counts(n);
+
+		ThreadPool::Body query = [&](std::size_t begin, std::size_t end,
+				std::size_t) {
+			for (auto k = begin; k < end; k++) {
+				std::size_t i = grid.index()[k];
+				std::size_t c = 0;
+				grid.forEachNeighbor(grid.sorted(k), RADIUS,
+						[&c](std::size_t, Vec2, float) {
+							c++;
+						});
+				counts[i] = c;
+			}
+		};
+
+		double tBuild1 = time_per_run([&]() {
+			grid.build(pos);
+		}, reps);
+		double tBuild = time_per_run([&]() {
+			grid.build(pos, &pool);
+		}, reps);
+		double tQuery = time_per_run([&]() {
+			pool.parallelFor(n, query, 256);
+		}, reps);
+
+		double avg = 0.0;
+		for (auto c : counts)
+			avg += c;
+		avg /= n;
+
+		std::cout << n << " asteroids (" << avg << " neighbors on average):"
+				<< std::endl;
+		std::cout << "  build, 1 thread: " << tBuild1 << " ms" << std::endl;
+		std::cout << "  build, pool: " << tBuild << " ms" << std::endl;
+		std::cout << "  queries, pool: " << tQuery << " ms" << std::endl;
+		std::cout << "  total: " << (tBuild + tQuery) * 1e6 / n
+				<< " ns/asteroid" << std::endl;
+	}
+}
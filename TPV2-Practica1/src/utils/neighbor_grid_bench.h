@@ -0,0 +1,8 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+// Correctness check and scaling benchmark of NeighborGrid, in the same
+// spirit as the demos: call it from main and read the output.
+//
+void neighbor_grid_bench(void);
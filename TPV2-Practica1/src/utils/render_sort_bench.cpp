@@ -0,0 +1,115 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "render_sort_bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "RadixSort.h"
+
+// the same layout as the keys of RenderList
+static const int LAYER_SHIFT = 56;
+static const int TEXTURE_SHIFT = 40;
+
+// runs f() 'reps' times and returns milliseconds per run
+template<typename F>
+static double time_per_run(F f, int reps) {
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < reps; r++)
+		f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count()
+			/ reps;
+}
+
+// The keys of a frame with n sprites, in the order the game records them:
+// asteroids of two textures in whatever order the entities are (random
+// here), then particles of two textures, then bullets, then the HUD. The
+// same in every run.
+static void frame(std::vector<std::uint64_t> &keys, std::size_t n) {
+	unsigned int seed = 12345u;
+	auto next = [&seed](unsigned int m) {
+		seed = seed * 1103515245u + 12345u;
+		return (seed >> 8) % m;
+	};
+	auto key = [](std::uint64_t layer, std::uint64_t tex) {
+		return (layer << LAYER_SHIFT) | (tex << TEXTURE_SHIFT);
+	};
+
+	keys.clear();
+	keys.push_back(0); // clear
+	for (std::size_t i = 0; i < n / 2; i++)
+		keys.push_back(key(0, 1 + next(2))); // asteroid, asteroid_gold
+	keys.push_back(key(0, 3)); // fighter
+	while (keys.size() < n * 9 / 10)
+		keys.push_back(key(1, 4 + next(2))); // particles
+	while (keys.size() < n - 10)
+		keys.push_back(key(2, 6)); // bullets
+	while (keys.size() < n)
+		keys.push_back(key(3, 7 + next(2))); // hearts, text
+}
+
+// number of times the texture changes from one command to the next
+static std::size_t switches(const std::vector<std::uint64_t> &keys) {
+	std::size_t s = 0;
+	for (std::size_t i = 1; i < keys.size(); i++)
+		if ((keys[i] >> TEXTURE_SHIFT) != (keys[i - 1] >> TEXTURE_SHIFT))
+			s++;
+	return s;
+}
+
+void render_sort_bench() {
+
+	const int reps = 50;
+
+	for (std::size_t n : { 10000u, 100000u }) {
+		std::vector<std::uint64_t> keys0;
+		frame(keys0, n);
+
+		std::vector<std::uint64_t> keys(n), tmpKeys(n);
+		std::vector<std::uint32_t> order(n), tmpOrder(n);
+		auto radixSort = [&]() {
+			keys = keys0;
+			for (std::size_t i = 0; i < n; i++)
+				order[i] = static_cast<std::uint32_t>(i);
+			radix::sort(keys.data(), order.data(), n, tmpKeys.data(),
+					tmpOrder.data());
+		};
+
+		std::vector<std::pair<std::uint64_t, std::uint32_t>> pairs(n);
+		auto stdSort = [&]() {
+			for (std::size_t i = 0; i < n; i++)
+				pairs[i] = { keys0[i], static_cast<std::uint32_t>(i) };
+			std::stable_sort(pairs.begin(), pairs.end(),
+					[](const std::pair<std::uint64_t, std::uint32_t> &a,
+							const std::pair<std::uint64_t, std::uint32_t> &b) {
+						return a.first < b.first;
+					});
+		};
+
+		// ** correctness, the same order as std::stable_sort
+
+		radixSort();
+		stdSort();
+		std::size_t wrong = 0;
+		for (std::size_t i = 0; i < n; i++)
+			if (order[i] != pairs[i].second)
+				wrong++;
+
+		double tRadix = time_per_run(radixSort, reps);
+		double tStd = time_per_run(stdSort, reps);
+
+		std::cout << n << " sprites:" << std::endl;
+		std::cout << "  positions that differ from std::stable_sort: " << wrong
+				<< std::endl;
+		std::cout << "  texture switches: " << switches(keys0)
+				<< " recorded, " << switches(keys) << " sorted" << std::endl;
+		std::cout << "  radix sort: " << tRadix << " ms ("
+				<< tRadix * 1e6 / n << " ns/sprite)" << std::endl;
+		std::cout << "  std::stable_sort: " << tStd << " ms" << std::endl;
+	}
+}
@@ -0,0 +1,9 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+// Correctness check and benchmark of the sorting of render commands (see
+// RenderList and radix::sort), in the same spirit as the demos: call it
+// from main and read the output.
+//
+void render_sort_bench(void);
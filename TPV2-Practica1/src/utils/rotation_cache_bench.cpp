@@ -0,0 +1,90 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "rotation_cache_bench.h"
+
+#include <SDL.h>
+#include <chrono>
+#include <iostream>
+
+#include "../sdlutils/RotationCache.h"
+#include "../sdlutils/SpriteBatch.h"
+#include "../sdlutils/Texture.h"
+
+// runs f() 'reps' times and returns milliseconds per run
+template<typename F>
+static double time_per_run(F f, int reps) {
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < reps; r++)
+		f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count()
+			/ reps;
+}
+
+void rotation_cache_bench() {
+
+	const int width = 800, height = 600;
+	const int sprites = 1000; // per run
+	const int reps = 20;
+
+	// the software renderer, drawing to a surface (no window needed)
+	SDL_Surface *surface = SDL_CreateSurface(width, height,
+			SDL_PIXELFORMAT_ARGB8888);
+	SDL_Renderer *renderer =
+			surface == nullptr ? nullptr : SDL_CreateSoftwareRenderer(surface);
+	if (renderer == nullptr) {
+		std::cout << "rotation_cache_bench: " << SDL_GetError() << std::endl;
+		SDL_DestroySurface(surface);
+		return;
+	}
+
+	{
+		Texture tex(renderer, "resources/images/fighter.png");
+		RotationCache cache(renderer, tex, 72);
+		SpriteBatch batch;
+		float w = static_cast<float>(tex.width());
+		float h = static_cast<float>(tex.height());
+
+		// the sprites of a run, at every multiple of 5 degrees
+		auto dest = [=](int i) {
+			return SDL_FRect { static_cast<float>((i * 37) % (width - 60)),
+					static_cast<float>((i * 53) % (height - 60)), w, h };
+		};
+		auto angle = [](int i) {
+			return 5.0f * (i % 72);
+		};
+
+		double rotated = time_per_run([&]() {
+			for (int i = 0; i < sprites; i++)
+				tex.render(dest(i), angle(i));
+			SDL_FlushRenderer(renderer);
+		}, reps);
+
+		double batched = time_per_run([&]() {
+			for (int i = 0; i < sprites; i++)
+				batch.draw(tex, dest(i), angle(i));
+			batch.flush();
+			SDL_FlushRenderer(renderer);
+		}, reps);
+
+		batch.setRotations(tex, &cache);
+		double cached = time_per_run([&]() {
+			for (int i = 0; i < sprites; i++)
+				batch.draw(tex, dest(i), angle(i));
+			batch.flush();
+			SDL_FlushRenderer(renderer);
+		}, reps);
+		batch.setRotations(tex, nullptr);
+
+		std::cout << sprites << " rotated sprites of " << tex.width() << "x"
+				<< tex.height() << " (software renderer, ms per frame)"
+				<< std::endl;
+		std::cout << "  SDL_RenderTextureRotated: " << rotated << std::endl;
+		std::cout << "  SpriteBatch, rotated:     " << batched << std::endl;
+		std::cout << "  SpriteBatch, cached:      " << cached << " ("
+				<< cache.numAngles() << " angles)" << std::endl;
+	}
+
+	SDL_DestroyRenderer(renderer);
+	SDL_DestroySurface(surface);
+}
@@ -0,0 +1,11 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+// Benchmark of drawing a rotating sprite with the software renderer:
+// rotated (SDL_RenderTextureRotated, and a rotated quad of a SpriteBatch)
+// against the nearest frame of a RotationCache, not rotated. In the same
+// spirit as the demos: call it from main (after SDL_Init) and read the
+// output.
+//
+void rotation_cache_bench(void);
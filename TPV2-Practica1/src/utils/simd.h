@@ -0,0 +1,18 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+/*
+ * Detects whether SSE2 intrinsics can be used. All x64 compilers support
+ * it, for 32-bit builds we rely on the corresponding compiler flag.
+ *
+ *  _M_X64, _M_IX86_FP for Visual Studio
+ *  __SSE2__ for g++/clang
+ *
+ * Code that uses SSE2 must always have a scalar version as well, in the
+ * '#else' branch of '#ifdef _USE_SSE2'.
+ */
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define _USE_SSE2
+#include <emmintrin.h>
+#endif
@@ -0,0 +1,232 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#include "vector2d_bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "FastRotation.h"
+#include "Vec2Batch.h"
+#include "Vector2D.h"
+
+#define PI 3.14159265358979323846264338327950288f
+
+// The implementation of Vector2D::rotate before the sine/cosine cache, used
+// as reference for the accuracy checks
+//
+static Vector2D reference_rotate(const Vector2D &v, float degrees) {
+	degrees = fmodf(degrees, 360.0f);
+	if (degrees > 180.0f) {
+		degrees = degrees - 360.0f;
+	} else if (degrees <= -180.0f) {
+		degrees = 360.0f + degrees;
+	}
+
+	float angle = degrees * PI / 180.0f;
+	float sine = sinf(angle);
+	float cosine = cosf(angle);
+
+	float matrix[2][2] = { { cosine, -sine }, { sine, cosine } };
+
+	return Vector2D(matrix[0][0] * v.getX() + matrix[0][1] * v.getY(),
+			matrix[1][0] * v.getX() + matrix[1][1] * v.getY());
+}
+
+static float error(const Vector2D &a, const Vector2D &b) {
+	return std::max(std::fabs(a.getX() - b.getX()),
+			std::fabs(a.getY() - b.getY()));
+}
+
+// runs f() 'reps' times and returns nanoseconds per vector
+template<typename F>
+static double time_per_vector(F f, int reps, std::size_t n) {
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < reps; r++)
+		f();
+	auto end = std::chrono::steady_clock::now();
+	double ns = static_cast<double>(std::chrono::duration_cast<
+			std::chrono::nanoseconds>(end - start).count());
+	return ns / (static_cast<double>(reps) * n);
+}
+
+void fast_rotation_bench() {
+
+	const std::size_t n = 10000;
+	const int reps = 200;
+
+	std::vector<Vector2D> vs(n);
+	for (auto i = 0u; i < n; i++)
+		vs[i].set(std::cos(i * 0.37f) * (1.0f + i % 7),
+				std::sin(i * 0.11f) * (1.0f + i % 5));
+
+	// ** accuracy against the reference implementation
+
+	float maxErrFixed = 0.0f; // +-1, +-5
+	float maxErrTable = 0.0f; // multiples of 5, including out of range ones
+	float maxErrBatch = 0.0f; // batch AoS and SoA
+	const SinCos *fixed[] = { &fastrot::plus1(), &fastrot::minus1(),
+			&fastrot::plus5(), &fastrot::minus5() };
+	const float fixedDeg[] = { 1.0f, -1.0f, 5.0f, -5.0f };
+
+	for (auto i = 0u; i < n; i++) {
+		for (int k = 0; k < 4; k++)
+			maxErrFixed = std::max(maxErrFixed,
+					error(vs[i].rotate(fixed[k]->sin, fixed[k]->cos),
+							reference_rotate(vs[i], fixedDeg[k])));
+
+		float deg = 5.0f * (static_cast<int>(i % 200) - 100);
+		SinCos sc = fastrot::steps5().get(deg);
+		maxErrTable = std::max(maxErrTable,
+				error(vs[i].rotate(sc.sin, sc.cos),
+						reference_rotate(vs[i], deg)));
+	}
+
+	std::vector<Vector2D> aos(vs);
+	std::vector<float> xs(n), ys(n);
+	for (auto i = 0u; i < n; i++) {
+		xs[i] = vs[i].getX();
+		ys[i] = vs[i].getY();
+	}
+	const SinCos &r = fastrot::plus1();
+	fastrot::rotate(aos.data(), n, r.sin, r.cos);
+	fastrot::rotate(xs.data(), ys.data(), n, r.sin, r.cos);
+	for (auto i = 0u; i < n; i++) {
+		Vector2D ref = reference_rotate(vs[i], 1.0f);
+		maxErrBatch = std::max(maxErrBatch, error(aos[i], ref));
+		maxErrBatch = std::max(maxErrBatch,
+				error(Vector2D(xs[i], ys[i]), ref));
+	}
+
+	std::cout << "max error (fixed angles): " << maxErrFixed << std::endl;
+	std::cout << "max error (5 degrees table): " << maxErrTable << std::endl;
+	std::cout << "max error (batch): " << maxErrBatch << std::endl;
+
+	// ** timing, the same work with each method
+
+	float sink = 0.0f; // keeps the compiler from removing the loops
+
+	double tRef = time_per_vector([&]() {
+		for (auto &v : aos)
+			v = v.rotate(1.0f);
+		sink += aos[0].getX();
+	}, reps, n);
+
+	double tCached = time_per_vector([&]() {
+		for (auto &v : aos)
+			v = v.rotate(r.sin, r.cos);
+		sink += aos[0].getX();
+	}, reps, n);
+
+	double tAoS = time_per_vector([&]() {
+		fastrot::rotate(aos.data(), n, r.sin, r.cos);
+		sink += aos[0].getX();
+	}, reps, n);
+
+	double tSoA = time_per_vector([&]() {
+		fastrot::rotate(xs.data(), ys.data(), n, r.sin, r.cos);
+		sink += xs[0];
+	}, reps, n);
+
+	std::cout << "rotate(degrees): " << tRef << " ns/vector" << std::endl;
+	std::cout << "rotate(sin,cos): " << tCached << " ns/vector" << std::endl;
+	std::cout << "batch rotate (Vector2D array): " << tAoS << " ns/vector"
+			<< std::endl;
+	std::cout << "batch rotate (x/y arrays): " << tSoA << " ns/vector"
+			<< std::endl;
+	std::cout << "(ignore: " << sink << ")" << std::endl;
+}
+
+void vec2_batch_bench() {
+
+	const std::size_t n = 10000;
+	const int reps = 200;
+
+	std::vector<Vector2D> vs(n);
+	Vec2Buffer a(n), b(n), out(n);
+	for (auto i = 0u; i < n; i++) {
+		// every 100th vector is (0,0), to exercise normalizeOrZero
+		Vec2 v = i % 100 == 0 ?
+				Vec2() :
+				Vec2(std::cos(i * 0.37f) * (1.0f + i % 7),
+						std::sin(i * 0.11f) * (1.0f + i % 5));
+		vs[i] = toVector2D(v);
+		a.span().set(i, v);
+		b.span().set(i, v.perp());
+	}
+	const Vec2 p(3.0f, -2.0f);
+
+	// ** accuracy against Vector2D (and Vec2 for the zero vectors)
+
+	float errAdd = 0.0f, errScale = 0.0f, errNorm = 0.0f, errDist = 0.0f;
+
+	vec2batch::add(out, a, b);
+	for (auto i = 0u; i < n; i++)
+		errAdd = std::max(errAdd, error(toVector2D(out[i]),
+						vs[i] + toVector2D(b[i])));
+
+	vec2batch::scale(out, a, 1.5f);
+	for (auto i = 0u; i < n; i++)
+		errScale = std::max(errScale, error(toVector2D(out[i]), vs[i] * 1.5f));
+
+	vec2batch::normalizeOrZero(out, a);
+	for (auto i = 0u; i < n; i++) {
+		Vector2D ref = i % 100 == 0 ? Vector2D() : vs[i].normalize();
+		errNorm = std::max(errNorm, error(toVector2D(out[i]), ref));
+	}
+
+	std::vector<float> d2(n);
+	vec2batch::distanceSq(d2.data(), a, p);
+	float minRef = -1.0f;
+	for (auto i = 0u; i < n; i++) {
+		float ref = (vs[i] - toVector2D(p)).magnitude();
+		ref = ref * ref;
+		errDist = std::max(errDist, std::fabs(d2[i] - ref) / std::max(ref, 1.0f));
+		minRef = minRef < 0.0f ? ref : std::min(minRef, ref);
+	}
+	float minErr = std::fabs(vec2batch::minDistanceSq(a, p) - minRef);
+
+	std::cout << "max error (add): " << errAdd << std::endl;
+	std::cout << "max error (scale): " << errScale << std::endl;
+	std::cout << "max error (normalizeOrZero): " << errNorm << std::endl;
+	std::cout << "max relative error (distanceSq): " << errDist << std::endl;
+	std::cout << "error (minDistanceSq): " << minErr << std::endl;
+
+	// ** timing, Vector2D loop vs kernel
+
+	float sink = 0.0f;
+	std::vector<Vector2D> tmp(n);
+
+	double tNormRef = time_per_vector([&]() {
+		for (auto i = 0u; i < n; i++)
+			tmp[i] = vs[i].normalize();
+		sink += tmp[1].getX();
+	}, reps, n);
+
+	double tNorm = time_per_vector([&]() {
+		vec2batch::normalizeOrZero(out, a);
+		sink += out[1].x;
+	}, reps, n);
+
+	double tMinRef = time_per_vector([&]() {
+		float m = 1e30f;
+		for (auto i = 0u; i < n; i++)
+			m = std::min(m, (vs[i] - toVector2D(p)).magnitude());
+		sink += m;
+	}, reps, n);
+
+	double tMin = time_per_vector([&]() {
+		sink += vec2batch::minDistanceSq(a, p);
+	}, reps, n);
+
+	std::cout << "Vector2D::normalize: " << tNormRef << " ns/vector" << std::endl;
+	std::cout << "vec2batch::normalizeOrZero: " << tNorm << " ns/vector"
+			<< std::endl;
+	std::cout << "min distance with Vector2D: " << tMinRef << " ns/vector"
+			<< std::endl;
+	std::cout << "vec2batch::minDistanceSq: " << tMin << " ns/vector"
+			<< std::endl;
+	std::cout << "(ignore: " << sink << ")" << std::endl;
+}
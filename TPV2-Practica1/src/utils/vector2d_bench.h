@@ -0,0 +1,9 @@
+// This file is part of the course TPV2@UCM - Samir Genaim
+
+#pragma once
+
+// Accuracy checks and micro-benchmarks of the vector math, in the same
+// spirit as the demos: call them from main and read the output.
+//
+void fast_rotation_bench(void);
+void vec2_batch_bench(void);